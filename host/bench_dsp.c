@@ -0,0 +1,1133 @@
+// Benchmark nativo do caminho crítico do afinador.
+//
+// Para cada tamanho de bloco e taxa de amostragem, mede cada rotina sobre um sinal
+// sintético (corda com harmônicos e ruído) e imprime uma linha CSV:
+//   routine,buffer_size,sample_rate,ns_per_frame,frames_per_s,allocs_per_frame
+//
+// decimator_x16 produz um bloco de buffer_size amostras a partir de 16 x buffer_size
+// amostras do ADC: ns por amostra de entrada = ns_per_frame / (16 x buffer_size).
+//
+// Antes das medições, confere cada módulo (check_pitch, check_strobe, ...: o caminho em
+// ponto fixo contra uma referência em double ou contra o sinal sintetizado) e sai com
+// código 1 se alguma tolerância for violada.
+//
+// Opções: --min-ms N (tempo mínimo por medição, padrão 200), --filter nome
+//
+// Com --replay arquivo.wav (ex.: gerado por record_to_wav), não mede nada: passa a
+// gravação pelo mesmo caminho do firmware (decimação até 4 kHz se preciso, blocos de
+// 512 amostras, perfil cromático) e imprime uma linha CSV por bloco:
+//   block,time_s,rms,noise_floor,frequency_hz,note,cents
+
+#include "tuner.h"
+#include "pitch.h"
+#include "fft.h"
+#include "decimator.h"
+#include "strobe.h"
+#include "strum.h"
+#include "profiles.h"
+#include "tone.h"
+#include "record.h"
+#include "analysis.h"
+#include "level.h"
+#include "tracker.h"
+#include "capture.h"
+#include "buttons.h"
+#include "wav.h"
+#include "note_map.h"
+#include "fixed.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ---------------------------------------------------------------------------
+// Contagem de alocações (ligada com -Wl,--wrap=...)
+
+static unsigned long alloc_count = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+void *__wrap_malloc(size_t size) { alloc_count++; return __real_malloc(size); }
+void *__wrap_calloc(size_t n, size_t size) { alloc_count++; return __real_calloc(n, size); }
+void *__wrap_realloc(void *ptr, size_t size) { alloc_count++; return __real_realloc(ptr, size); }
+void __wrap_free(void *ptr) { __real_free(ptr); }
+
+// ---------------------------------------------------------------------------
+// Casos medidos
+
+typedef struct {
+    const uint16_t *buffer;
+    const int16_t *centered;    // O mesmo bloco sem DC (entrada do detector)
+    uint32_t size;
+    uint32_t sample_rate;
+} bench_input_t;
+
+typedef float (*bench_fn_t)(const bench_input_t *in);
+
+typedef struct {
+    const char *name;
+    bench_fn_t run;
+} bench_case_t;
+
+static fixed_t state_freq = FIXED_FROM_INT(110);  // Última frequência acompanhada
+static tracker_t bench_tracker;
+
+static float to_float(fixed_t value) {
+    return (float)value / FIXED_ONE;
+}
+
+// Nível do bloco (DC, RMS, pico e porta) numa passada, escrevendo o bloco sem DC
+static level_t bench_level;
+static int16_t bench_centered[2048];
+
+static float run_level(const bench_input_t *in) {
+    level_reading_t reading;
+    level_process(&bench_level, in->buffer, in->size, bench_centered, &reading);
+    return reading.rms;
+}
+
+static float run_frequency(const bench_input_t *in) {
+    return to_float(calculate_frequency(in->centered, in->size, in->sample_rate));
+}
+
+// Uma estimativa por salto de 64 amostras, alternando 3 cents em torno de 110 Hz
+static float run_tracker(const bench_input_t *in) {
+    static bool odd = false;
+    odd = !odd;
+    (void)in;
+    state_freq = tracker_update(&bench_tracker, odd ? FIXED_CONST(110.1) : FIXED_CONST(109.9), Q15_CONST(0.9), 64);
+    return to_float(state_freq);
+}
+
+static float run_closest_note(const bench_input_t *in) {
+    (void)in;
+    note_info_t note;
+    get_closest_note(state_freq, &note);
+    return to_float(note.cents);
+}
+
+static float run_pitch_mpm(const bench_input_t *in) {
+    pitch_result_t result;
+    pitch_detect(in->centered, in->size, in->sample_rate, MIN_DETECT_FREQ, MAX_DETECT_FREQ, &result);
+    return to_float(result.frequency);
+}
+
+// O mesmo detector com o perfil do violão: faixa de 65 a 440 Hz e só a janela do
+// perfil no fim do bloco (256 amostras a 4 kHz)
+static float run_pitch_guitar(const bench_input_t *in) {
+    const tuning_profile_t *profile = profile_get(PROFILE_GUITAR);
+    uint32_t window = profile_window(profile, in->sample_rate, in->size);
+    pitch_result_t result;
+    pitch_detect(in->centered + in->size - window, window, in->sample_rate, profile->min_freq, profile->max_freq, &result);
+    return to_float(result.frequency);
+}
+
+static fft_plan_t bench_plan;
+
+static float run_fft_hps(const bench_input_t *in) {
+    return to_float(fft_detect_fundamental(&bench_plan, in->centered, in->sample_rate, MIN_DETECT_FREQ, MAX_DETECT_FREQ));
+}
+
+// Um salto de 64 amostras da análise contínua (janela = tamanho do bloco, até 1024).
+// Custo por segundo: ns_per_frame x sample_rate / 64.
+#define BENCH_HOP 64
+static pitch_stream_t bench_stream;
+static uint32_t stream_pos = 0;
+
+static float run_pitch_stream(const bench_input_t *in) {
+    pitch_result_t result = {0};
+    if (stream_pos + BENCH_HOP > in->size) stream_pos = 0;
+    pitch_stream_push(&bench_stream, in->centered + stream_pos, BENCH_HOP, true, &result);
+    stream_pos += BENCH_HOP;
+    return to_float(result.frequency);
+}
+
+// Bloco de análise obtido do ADC sobreamostrado 16x (CIC + dois meia-banda)
+#define BENCH_OVERSAMPLING 16
+static uint16_t bench_raw[2048 * BENCH_OVERSAMPLING];
+static uint16_t bench_decimated[2048 + 1];
+static decimator_t bench_decimator;
+
+static float run_decimator(const bench_input_t *in) {
+    uint32_t n = decimator_process(&bench_decimator, bench_raw, in->size * BENCH_OVERSAMPLING, bench_decimated);
+    return (float)bench_decimated[n - 1];
+}
+
+// Estrobo travado em 110 Hz sobre um bloco inteiro (custo por amostra = ns_per_frame / buffer_size)
+static strobe_t bench_strobe;
+
+static float run_strobe(const bench_input_t *in) {
+    strobe_reading_t reading;
+    strobe_process(&bench_strobe, in->buffer, in->size);
+    strobe_read(&bench_strobe, &reading);
+    return to_float(reading.cents);
+}
+
+// Banco de Goertzel das seis cordas sobre um bloco inteiro, comparado com a FFT real
+// do mesmo bloco (só a transformada e os módulos, sem o produto harmônico)
+static strum_t bench_strum;
+static int16_t bench_fft_work[2048];
+static uint16_t bench_fft_mag[1024];
+
+static float run_strum(const bench_input_t *in) {
+    strum_process(&bench_strum, in->buffer, in->size);
+    return to_float(bench_strum.reading.strings[0].cents);
+}
+
+static float run_fft_forward(const bench_input_t *in) {
+    for (uint32_t i = 0; i < in->size; i++) bench_fft_work[i] = (int16_t)(in->buffer[i] - 2048);
+    fft_real_forward(&bench_plan, bench_fft_work);
+    fft_magnitude(&bench_plan, bench_fft_work, bench_fft_mag);
+    return (float)bench_fft_mag[1];
+}
+
+// Quadro completo do TUNER_MODE (sem E/S). A porta recomeça a cada quadro: repetido
+// por minutos, o mesmo bloco acabaria virando o piso de ruído.
+static float run_frame(const bench_input_t *in) {
+    level_reading_t reading;
+    level_init(&bench_level, in->sample_rate, 53);
+    if (!level_process(&bench_level, in->buffer, in->size, bench_centered, &reading)) return 0.0f;
+    fixed_t f = calculate_frequency(bench_centered, in->size, in->sample_rate);
+    state_freq = tracker_update(&bench_tracker, f, detected_clarity, in->size);
+    note_info_t note;
+    get_closest_note(state_freq, &note);
+    return to_float(note.cents);
+}
+
+// Novos detectores entram aqui
+static const bench_case_t cases[] = {
+    {"level_process", run_level},
+    {"calculate_frequency", run_frequency},
+    {"tracker_update", run_tracker},
+    {"get_closest_note", run_closest_note},
+    {"pitch_detect_mpm", run_pitch_mpm},
+    {"pitch_detect_guitar", run_pitch_guitar},
+    {"fft_hps", run_fft_hps},
+    {"pitch_stream_hop64", run_pitch_stream},
+    {"decimator_x16", run_decimator},
+    {"strobe_process", run_strobe},
+    {"strum_bank", run_strum},
+    {"fft_forward", run_fft_forward},
+    {"tuner_frame", run_frame},
+};
+
+// ---------------------------------------------------------------------------
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Bloco sem DC pela média, como o detector recebe depois de level_process()
+static void center_block(const uint16_t *buffer, uint32_t size, int16_t *centered) {
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < size; i++) sum += buffer[i];
+    int32_t mean = (int32_t)(sum / size);
+    for (uint32_t i = 0; i < size; i++) centered[i] = (int16_t)((int32_t)buffer[i] - mean);
+}
+
+// ---------------------------------------------------------------------------
+// Sinais sintéticos
+
+#define SYNTH_HARMONICS 4
+
+// Corda sintética: harmônicos 1..SYNTH_HARMONICS de freq, cada um com amplitude e
+// fase próprias. A fase continua entre chamadas, então a mesma corda pode ser
+// gerada bloco a bloco, e várias cordas podem ser somadas no mesmo sinal.
+typedef struct {
+    double freq, rate;
+    double amps[SYNTH_HARMONICS];
+    double offsets[SYNTH_HARMONICS];
+    double phase;  // Fase da fundamental (rad)
+} synth_t;
+
+static double bench_synth[2048 * BENCH_OVERSAMPLING];
+
+// Corda com fundamental e três harmônicos (o 2º mais forte que a fundamental)
+static synth_t synth_string(double freq, double rate, double gain) {
+    synth_t sy = {freq, rate, {300.0 * gain, 500.0 * gain, 250.0 * gain, 100.0 * gain}, {0.0, 1.0, 2.0, 0.5}, 0.0};
+    return sy;
+}
+
+static synth_t synth_sine(double freq, double rate, double amplitude) {
+    synth_t sy = {freq, rate, {amplitude}, {0.0}, 0.0};
+    return sy;
+}
+
+// Soma `count` amostras da corda em v
+static void synth_add(synth_t *sy, double *v, uint32_t count) {
+    double step = 2.0 * M_PI * sy->freq / sy->rate;
+    for (uint32_t i = 0; i < count; i++) {
+        for (uint32_t k = 0; k < SYNTH_HARMONICS; k++) {
+            if (sy->amps[k] != 0.0) v[i] += sy->amps[k] * sin((k + 1) * sy->phase + sy->offsets[k]);
+        }
+        sy->phase = fmod(sy->phase + step, 2.0 * M_PI);
+    }
+}
+
+// Amostras do ADC: v em torno de bias, com ruído uniforme de +-noise (rand())
+static void synth_adc(const double *v, uint16_t *out, uint32_t count, double bias, int noise) {
+    for (uint32_t i = 0; i < count; i++) {
+        double n = (noise > 0) ? rand() % (2 * noise + 1) - noise : 0;
+        out[i] = (uint16_t)lround(bias + v[i] + n);
+    }
+}
+
+// Uma corda sozinha, do começo, centrada em 2048 com ruído de +-20
+static void make_signal(uint16_t *buffer, uint32_t size, uint32_t sample_rate, float freq) {
+    synth_t sy = synth_string(freq, sample_rate, 1.0);
+    memset(bench_synth, 0, size * sizeof(double));
+    synth_add(&sy, bench_synth, size);
+    srand(1);
+    synth_adc(bench_synth, buffer, size, 2048.0, 20);
+}
+
+// ---------------------------------------------------------------------------
+// Conferência do caminho em ponto fixo contra uma referência em double.
+// Tolerâncias:
+//   pitch_detect e pitch_stream: até 0,1 cent do mesmo MPM calculado em double, também
+//                 com amostras em +-4095 (fundo de escala do ADC sem DC)
+//   capture:      blocos obtidos em ordem, sem lacunas (sequência +1), e overruns
+//                 contados quando o consumidor fica para trás
+//   tuner:        tons puros e cordas de E2 a E5 sem erro de oitava nem de duodécima
+//   note_map:     mesma nota MIDI e cents até 0,01 de 1200 x log2(f / alvo); o alvo de
+//                 note_map_note() igual ao da tabela em A4 de 430 a 450 Hz
+//   tracker:      ida e volta frequência -> cents absolutos -> frequência até 0,01 cent;
+//                 em estimativas com ~1,5 cent RMS de ruído e saltos de oitava isolados,
+//                 saída a até 0,5 cent RMS da nota; solta a nota entre 250 ms e um salto
+//                 depois; na análise contínua do firmware (saltos de 64, perfil do
+//                 violão), cada corda nova fica a 1 cent da leitura final em até 100 ms
+//   strobe:       até 0,2 cent do desvio sintetizado, após 4 s de sinal
+//   strum:        as seis cordas juntas, cada uma até 0,5 cent do seu desvio, após 4 s;
+//                 pela análise, sem leituras com as etapas desligadas e de novo até 0,5
+//                 cent 4 s depois de religar o banco
+//   tone:         frequência tocada (clk x num x períodos / (den x pontos)) até 1 mHz, em
+//                 todas as notas, com A4 de 432, 440 e 442 Hz e clk_sys de 125 e 128 MHz
+//   record:       quadros de 12 bits decodificados sem nenhuma diferença; byte corrompido rejeitado
+//   level:        DC (fora de 2048) e RMS até 1 contagem do exato após 1 s; a porta
+//                 fica fechada no ruído, abre no primeiro bloco da nota, segura a nota 9 dB
+//                 mais fraca (histerese) e fecha quando ela some
+//   fixed_append: texto a no máximo meia unidade da última casa do valor exato
+
+#define CHECK_PITCH_CENTS 0.1
+#define CHECK_NOTE_CENTS 0.01
+#define CHECK_TRACKER_ROUNDTRIP 0.01
+#define CHECK_TRACKER_HOLD 0.5
+#define CHECK_TRACKER_SETTLE_MS 100.0
+#define CHECK_STROBE_CENTS 0.2
+#define CHECK_STRUM_CENTS 0.5
+#define CHECK_TONE_HZ 0.001
+#define CHECK_LEVEL_DC 1.0
+#define CHECK_LEVEL_RMS 1.0
+
+static double cents_between(double a, double b) {
+    return 1200.0 * log2(a / b);
+}
+
+// MPM em double sobre amostras já sem DC (mesma faixa de atrasos, escolha de picos
+// e interpolação de pitch.c)
+static double ref_mpm(const double *x, uint32_t n, uint32_t sample_rate) {
+    static double v[PITCH_MAX_LAG + 2];
+
+    uint32_t min_lag = sample_rate / MAX_DETECT_FREQ;
+    uint32_t max_lag = sample_rate / MIN_DETECT_FREQ + 1;
+    if (min_lag < 2) min_lag = 2;
+    if (max_lag > n / 2) max_lag = n / 2;
+    if (max_lag > PITCH_MAX_LAG) max_lag = PITCH_MAX_LAG;
+
+    uint32_t first = min_lag - 1;
+    for (uint32_t tau = first; tau <= max_lag + 1; tau++) {
+        double r = 0.0, m = 0.0;
+        for (uint32_t i = 0; i + tau < n; i++) {
+            r += x[i] * x[i + tau];
+            m += x[i] * x[i] + x[i + tau] * x[i + tau];
+        }
+        v[tau - first] = (m > 0.0) ? 2.0 * r / m : 0.0;
+    }
+
+    uint32_t last = max_lag - first, keys[32], count = 0, best = 0;
+    double highest = 0.0;
+    for (uint32_t k = 1; k < last; k++) {
+        if (v[k] > 0.0 && v[k] > v[k - 1] && v[k] >= v[k + 1]) {
+            if (best == 0 || v[k] > v[best]) best = k;
+        }
+        if ((v[k] <= 0.0 || k == last - 1) && best != 0) {
+            if (count < 32) keys[count++] = best;
+            if (v[best] > highest) highest = v[best];
+            best = 0;
+        }
+    }
+    if (count == 0) return 0.0;
+    uint32_t k = keys[0];
+    for (uint32_t i = 0; i < count; i++) {
+        if (v[keys[i]] >= 0.9 * highest) {
+            k = keys[i];
+            break;
+        }
+    }
+
+    double a = v[k - 1], b = v[k], c = v[k + 1];
+    double denom = a - 2.0 * b + c;
+    double delta = (denom != 0.0) ? 0.5 * (a - c) / denom : 0.0;
+    if (delta > 0.5) delta = 0.5;
+    if (delta < -0.5) delta = -0.5;
+    return (double)sample_rate / ((double)(k + first) + delta);
+}
+
+static bool check_report(const char *name, double worst, double tolerance) {
+    bool ok = worst <= tolerance;
+    fprintf(stderr, "check,%s,%.6f,%.6f,%s\n", name, worst, tolerance, ok ? "ok" : "FALHOU");
+    return ok;
+}
+
+static bool check_pitch(void) {
+    static uint16_t buffer[2048];
+    static int16_t centered[2048];
+    static double x[2048];
+    static const uint32_t sizes[] = {512, 1024, 2048};
+    static const uint32_t rates[] = {4000, 8000};
+    static const float freqs[] = {41.2f, 55.0f, 82.41f, 110.0f, 146.83f, 196.0f, 246.94f, 329.63f, 440.0f, 659.26f, 987.77f};
+    bool ok = true;
+
+    // Mesma janela (sem DC pela média) nas duas aritméticas. A referência da janela
+    // deslizante usa as amostras do seu buffer.
+    double worst = 0.0, worst_stream = 0.0;
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+            for (size_t f = 0; f < sizeof(freqs) / sizeof(freqs[0]); f++) {
+                make_signal(buffer, sizes[s], rates[r], freqs[f]);
+                center_block(buffer, sizes[s], centered);
+                pitch_result_t result;
+                bool found = pitch_detect(centered, sizes[s], rates[r], MIN_DETECT_FREQ, MAX_DETECT_FREQ, &result);
+                for (uint32_t i = 0; i < sizes[s]; i++) x[i] = centered[i];
+                double ref = ref_mpm(x, sizes[s], rates[r]);
+                if (found && ref > 0.0) {
+                    double err = fabs(cents_between(to_float(result.frequency), ref));
+                    if (err > worst) worst = err;
+                }
+
+                pitch_stream_init(&bench_stream, sizes[s], BENCH_HOP, rates[r], MIN_DETECT_FREQ, MAX_DETECT_FREQ);
+                for (uint32_t i = 0; i < sizes[s]; i += BENCH_HOP) {
+                    found = pitch_stream_push(&bench_stream, centered + i, BENCH_HOP, true, &result);
+                }
+                uint32_t w = bench_stream.window;  // Limitada a PITCH_STREAM_MAX_WINDOW
+                const int16_t *window = &bench_stream.ring[(bench_stream.head - w) & (PITCH_STREAM_RING - 1)];
+                for (uint32_t i = 0; i < w; i++) x[i] = window[i];
+                ref = ref_mpm(x, w, rates[r]);
+                if (found && result.frequency > 0 && ref > 0.0) {
+                    double err = fabs(cents_between(to_float(result.frequency), ref));
+                    if (err > worst_stream) worst_stream = err;
+                }
+            }
+        }
+    }
+    ok &= check_report("pitch_detect_cents", worst, CHECK_PITCH_CENTS);
+    ok &= check_report("pitch_stream_cents", worst_stream, CHECK_PITCH_CENTS);
+
+    // Fundo de escala: level_process() entrega até +-4095 enquanto o DC se acomoda, e
+    // os produtos internos não podem transbordar (seno ceifado, quase quadrado)
+    double worst_full = 0.0;
+    for (size_t f = 0; f < sizeof(freqs) / sizeof(freqs[0]); f++) {
+        for (uint32_t i = 0; i < 2048; i++) {
+            double v = 6000.0 * sin(2.0 * M_PI * freqs[f] * i / 4000.0);
+            centered[i] = (int16_t)(v > 4095.0 ? 4095 : (v < -4095.0 ? -4095 : lround(v)));
+            x[i] = centered[i];
+        }
+        pitch_result_t result;
+        bool found = pitch_detect(centered, 2048, 4000, MIN_DETECT_FREQ, MAX_DETECT_FREQ, &result);
+        double ref = ref_mpm(x, 2048, 4000);
+        double err = (found && ref > 0.0) ? fabs(cents_between(to_float(result.frequency), ref)) : 100.0;
+        if (err > worst_full) worst_full = err;
+
+        pitch_stream_init(&bench_stream, 1024, BENCH_HOP, 4000, MIN_DETECT_FREQ, MAX_DETECT_FREQ);
+        for (uint32_t i = 0; i < 2048; i += BENCH_HOP) {
+            found = pitch_stream_push(&bench_stream, centered + i, BENCH_HOP, true, &result);
+        }
+        ref = ref_mpm(x + 2048 - 1024, 1024, 4000);
+        err = (found && result.frequency > 0 && ref > 0.0) ? fabs(cents_between(to_float(result.frequency), ref)) : 100.0;
+        if (err > worst_full) worst_full = err;
+    }
+    ok &= check_report("pitch_full_scale_cents", worst_full, CHECK_PITCH_CENTS);
+    return ok;
+}
+
+// Captura: uma rampa (amostra n vale n mod 2^16) entregue em pedaços de tamanho
+// ímpar, como a DMA. Cada bloco obtido deve continuar o anterior, com a sequência
+// subindo de 1. Depois, três blocos sem liberar: o consumidor pula para o último
+// (dois overruns), e um bloco que recebe mais dois enquanto é analisado conta mais um.
+static uint32_t capture_block_errors(const uint16_t *block, uint32_t seq) {
+    uint32_t errors = 0;
+    for (uint32_t i = 0; i < CAPTURE_BLOCK_SIZE; i++) errors += block[i] != (uint16_t)(seq * CAPTURE_BLOCK_SIZE + i);
+    return errors > 0;
+}
+
+static bool check_capture(void) {
+    static capture_t cap;
+    static uint16_t ramp[4 * CAPTURE_BLOCK_SIZE];
+    static const uint32_t chunks[] = {1, 7, 33, 129, 511, 3, 257, 65};  // Menores que um bloco
+    uint32_t fed = 0, errors = 0, expected_seq = 0;
+    capture_reset(&cap, 4000);
+
+    // Consumidor em dia: acquire/release depois de cada pedaço
+    for (uint32_t c = 0; fed < 40 * CAPTURE_BLOCK_SIZE; c++) {
+        uint32_t n = chunks[c % (sizeof(chunks) / sizeof(chunks[0]))];
+        for (uint32_t i = 0; i < n; i++) ramp[i] = (uint16_t)(fed + i);
+        capture_feed(&cap, ramp, n);
+        fed += n;
+
+        const uint16_t *block;
+        uint32_t seq;
+        while (capture_acquire(&cap, &block, &seq)) {
+            errors += seq != expected_seq++;
+            errors += capture_block_errors(block, seq);
+            capture_release(&cap);
+        }
+    }
+    errors += cap.overruns != 0;
+
+    // Completa o bloco em andamento e passa mais três sem liberar nada
+    uint32_t total = (cap.produced + 4) * CAPTURE_BLOCK_SIZE;
+    for (uint32_t c = 0; fed < total; c++) {
+        uint32_t n = chunks[c % (sizeof(chunks) / sizeof(chunks[0]))];
+        if (n > total - fed) n = total - fed;
+        for (uint32_t i = 0; i < n; i++) ramp[i] = (uint16_t)(fed + i);
+        capture_feed(&cap, ramp, n);
+        fed += n;
+    }
+    const uint16_t *block;
+    uint32_t seq;
+    uint32_t produced = cap.produced;
+    if (!capture_acquire(&cap, &block, &seq)) {
+        errors++;
+    } else {
+        errors += seq != produced - 1;
+        errors += cap.overruns != produced - expected_seq - 1;
+        errors += capture_block_errors(block, seq);
+
+        // Dois blocos chegam durante a análise: o bloco obtido foi sobrescrito
+        uint32_t overruns = cap.overruns;
+        for (uint32_t i = 0; i < 2 * CAPTURE_BLOCK_SIZE; i++) ramp[i] = (uint16_t)(fed + i);
+        capture_feed(&cap, ramp, 2 * CAPTURE_BLOCK_SIZE);
+        fed += 2 * CAPTURE_BLOCK_SIZE;
+        capture_release(&cap);
+        errors += cap.overruns != overruns + 1;
+
+        // A próxima aquisição volta a entregar um bloco íntegro, o mais recente
+        errors += !capture_acquire(&cap, &block, &seq) || seq != cap.produced - 1 || capture_block_errors(block, seq);
+        capture_release(&cap);
+    }
+    return check_report("capture_block_errors", errors, 0.0);
+}
+
+// Oitava do afinador (MPM + produto harmônico): tons puros e cordas com harmônicos, nos
+// blocos do modo cromático e na janela do perfil do violão. Conta as leituras a mais
+// de 50 cents da nota tocada (oitava ou duodécima erradas) e as sem leitura.
+static bool check_tuner(void) {
+    static uint16_t buffer[2048];
+    static int16_t centered[2048];
+    static const double freqs[] = {82.41, 110.0, 146.83, 196.0, 246.94, 329.63, 440.0, 659.26};
+    static const uint32_t sizes[] = {256, 512, 1024, 2048};
+    uint32_t errors = 0;
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        // 256 amostras: a janela do perfil do violão (65 a 440 Hz)
+        const tuning_profile_t *profile = (sizes[s] == 256) ? profile_get(PROFILE_GUITAR) : NULL;
+        tuner_set_profile(profile);
+        tuner_init(sizes[s]);
+        for (size_t f = 0; f < sizeof(freqs) / sizeof(freqs[0]); f++) {
+            if (profile && freqs[f] > profile->max_freq) continue;
+            for (int pure = 0; pure <= 1; pure++) {
+                synth_t sy = pure ? synth_sine(freqs[f], 4000, 600.0) : synth_string(freqs[f], 4000, 1.0);
+                memset(bench_synth, 0, sizes[s] * sizeof(double));
+                synth_add(&sy, bench_synth, sizes[s]);
+                srand(11);
+                synth_adc(bench_synth, buffer, sizes[s], 2048.0, 20);
+                center_block(buffer, sizes[s], centered);
+                fixed_t found = calculate_frequency(centered, sizes[s], 4000);
+                errors += found <= 0 || fabs(cents_between(to_float(found), freqs[f])) > 50.0;
+            }
+        }
+    }
+    tuner_set_profile(NULL);
+    return check_report("tuner_octave_errors", errors, 0.0);
+}
+
+// Nota e cents: varredura de 38 Hz a 2200 Hz em passos de ~1,2 cent
+static bool check_note_map(void) {
+    bool ok = true;
+    double worst = 0.0;
+    uint32_t wrong_notes = 0;
+    for (double f = 38.0; f < 2200.0; f *= 1.0007) {
+        fixed_t value = (fixed_t)lround(f * FIXED_ONE);
+        double exact = (double)value / FIXED_ONE;
+        double semitones = 12.0 * log2(exact / 440.0);
+        int midi = NOTE_MAP_A4_MIDI + (int)lround(semitones);
+        double cents = 100.0 * (semitones - lround(semitones));
+        if (fabs(cents) > 49.99) continue;  // Fronteira entre notas: qualquer lado serve
+
+        note_info_t note;
+        bool in_range = note_map_lookup(value, &note);
+        bool expected = midi >= NOTE_MAP_MIN_MIDI && midi <= NOTE_MAP_MAX_MIDI;
+        if (in_range != expected || (in_range && note.midi != midi)) {
+            wrong_notes++;
+            continue;
+        }
+        if (!in_range) continue;
+        double err = fabs(to_float(note.cents) - cents);
+        if (err > worst) worst = err;
+    }
+    ok &= check_report("note_map_midi_errors", wrong_notes, 0.0);
+    ok &= check_report("note_map_cents", worst, CHECK_NOTE_CENTS);
+
+    // note_map_note() calcula o alvo sem a tabela (usada pela tela no outro núcleo):
+    // tem de dar a mesma frequência que a tabela em qualquer referência
+    uint32_t target_mismatches = 0;
+    for (int a4 = 430; a4 <= 450; a4++) {
+        note_map_set_reference(FIXED_FROM_INT(a4));
+        for (int midi = NOTE_MAP_MIN_MIDI; midi <= NOTE_MAP_MAX_MIDI; midi++) {
+            note_info_t note;
+            note_map_note((uint8_t)midi, &note);
+            if (note.target_freq != note_map_frequency((uint8_t)midi)) target_mismatches++;
+        }
+    }
+    note_map_set_reference(NOTE_MAP_DEFAULT_A4);
+    ok &= check_report("note_map_target_mismatches", target_mismatches, 0.0);
+    return ok;
+}
+
+// Perfil personalizado pelo console: as cordas de cada perfil fixo, escritas em texto,
+// voltam as mesmas e com a faixa da tabela (arredondada à mão, até 1 Hz de diferença);
+// textos inválidos são recusados
+static bool check_profiles(void) {
+    uint32_t errors = 0;
+    double worst = 0.0;
+    for (uint8_t id = PROFILE_CHROMATIC; id < PROFILE_CUSTOM; id++) {
+        const tuning_profile_t *fixed = profile_get(id);
+        char text[64];
+        int used = 0;
+        for (uint8_t i = 0; i < fixed->strings; i++) {
+            used += snprintf(text + used, sizeof(text) - (size_t)used, "%s%s%d", (i > 0) ? " " : "",
+                             note_map_names[fixed->midi[i] % 12], fixed->midi[i] / 12 - 1);
+        }
+        text[used] = '\0';
+
+        tuning_profile_t parsed;
+        if (!profile_parse_custom(text, &parsed) || parsed.strings != fixed->strings ||
+            memcmp(parsed.midi, fixed->midi, fixed->strings) != 0) {
+            errors++;
+            continue;
+        }
+        double diff = fmax(fabs((double)parsed.min_freq - fixed->min_freq),
+                           fabs((double)parsed.max_freq - fixed->max_freq));
+        if (diff > worst) worst = diff;
+    }
+
+    static const char *const invalid[] = {"H2", "E", "E2x", "C8", "A0", "E2 A2 D3 G3 B3 E4 A4", "E2,,Q3"};
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        tuning_profile_t parsed;
+        if (profile_parse_custom(invalid[i], &parsed)) errors++;
+    }
+
+    bool ok = check_report("profile_parse_errors", errors, 0.0);
+    ok &= check_report("profile_range_hz", worst, 1.0);
+    return ok;
+}
+
+// Análise contínua como no firmware (AFINADOR_STREAMING): 4 kHz, saltos de 64 e o
+// perfil do violão (janela de 256 amostras). Ruído por 0,5 s e depois cada corda solta
+// por 1 s, sem pausa. O tempo até estabilizar vai do início da corda ao fim do último
+// salto cuja saída ficou a mais de 1 cent da leitura final (a do último salto): o
+// desvio do próprio detector nas cordas agudas a 4 kHz fica fora da conta.
+// Retorna o pior tempo (ms).
+static double tracker_settle_ms(void) {
+    static analysis_t an;
+    static pitch_stream_t ps;
+    static uint16_t hop[64];
+    static double v[64];
+    static fixed_t outputs[4000 / 64];
+    static const double strings[] = {82.41, 110.0, 146.83, 196.0, 246.94, 329.63};
+    const tuning_profile_t *profile = profile_get(PROFILE_GUITAR);
+    analysis_init(&an, 4000, 53);
+    pitch_stream_init(&ps, profile_window(profile, 4000, 1024), 64, 4000, profile->min_freq, profile->max_freq);
+    analysis_set_profile(&an, profile, 64);
+
+    double worst = 0.0;
+    uint32_t seq = 0;
+    synth_t sy = synth_string(0.0, 4000, 1.0);
+    srand(5);
+    for (int s = -1; s < (int)(sizeof(strings) / sizeof(strings[0])); s++) {
+        sy.freq = (s >= 0) ? strings[s] : 0.0;
+        uint32_t hops = (s >= 0) ? 4000 / 64 : 2000 / 64;
+        for (uint32_t h = 0; h < hops; h++) {
+            memset(v, 0, sizeof(v));
+            if (s >= 0) synth_add(&sy, v, 64);  // A fase segue de uma corda para a outra
+            synth_adc(v, hop, 64, 2048.0, 20);
+            analysis_result_t result;
+            analysis_process_stream(&an, &ps, hop, 64, seq++, &result);
+            outputs[h] = result.frequency;
+        }
+        if (s < 0) continue;
+
+        double last_bad = 0.0, final = to_float(outputs[hops - 1]);
+        for (uint32_t h = 0; h < hops; h++) {
+            if (outputs[h] <= 0 || fabs(cents_between(to_float(outputs[h]), final)) > 1.0) {
+                last_bad = (h + 1) * 64 * 1000.0 / 4000.0;
+            }
+        }
+        if (final <= 0.0 || fabs(cents_between(final, sy.freq)) > 5.0) last_bad = 1000.0;  // Nem chegou à corda
+        if (last_bad > worst) worst = last_bad;
+    }
+    return worst;
+}
+
+static bool check_tracker(void) {
+    bool ok = true;
+
+    // Ida e volta pela tabela de notas, de B0 a C7
+    double worst = 0.0;
+    for (double f = 31.0; f < 2090.0; f *= 1.0007) {
+        fixed_t value = (fixed_t)lround(f * FIXED_ONE), pitch;
+        if (!tracker_cents(value, &pitch)) continue;
+        double err = fabs(cents_between(to_float(tracker_frequency(pitch)), (double)value / FIXED_ONE));
+        if (err > worst) worst = err;
+    }
+    ok &= check_report("tracker_roundtrip_cents", worst, CHECK_TRACKER_ROUNDTRIP);
+
+    // Nota de 110 Hz com clareza entre 0,6 e 1 e ruído por estimativa de +-2 cents
+    // na clareza 0,9 (desvio proporcional a raiz de 1 - clareza), com um salto de
+    // oitava a cada 20 estimativas; depois silêncio até soltar a nota
+    tracker_t tr;
+    tracker_init(&tr, 4000);
+    uint32_t release_errors = 0;
+    double energy = 0.0;
+    srand(9);
+    for (int i = 0; i < 300; i++) {
+        q15_t clarity = (q15_t)(Q15_CONST(0.6) + rand() % (Q15_ONE - Q15_CONST(0.6)));
+        double spread = 2.0 * sqrt((Q15_ONE - clarity) / (double)(Q15_ONE - Q15_CONST(0.9)));
+        double cents = spread * (rand() % 2001 - 1000) / 1000.0;
+        double f = 110.0 * pow(2.0, cents / 1200.0) * ((i % 20 == 10) ? 2.0 : 1.0);
+        fixed_t out = tracker_update(&tr, (fixed_t)lround(f * FIXED_ONE), clarity, 64);
+        double err = (out > 0) ? cents_between(to_float(out), 110.0) : 100.0;
+        if (i >= 20) energy += err * err;
+    }
+    ok &= check_report("tracker_hold_cents", sqrt(energy / 280), CHECK_TRACKER_HOLD);
+
+    // Sem estimativas: segura a nota até 250 ms e solta até um salto depois
+    for (uint32_t elapsed = 64; elapsed <= 1200; elapsed += 64) {
+        bool held = tracker_update(&tr, 0, 0, 64) > 0;
+        release_errors += held != (elapsed < 4000 * TRACKER_RELEASE_MS / 1000);
+    }
+    // A nota seguinte trava já na primeira estimativa
+    fixed_t first = tracker_update(&tr, FIXED_CONST(146.83), Q15_CONST(0.9), 64);
+    release_errors += fabs(cents_between(to_float(first), 146.83)) > CHECK_TRACKER_ROUNDTRIP;
+    ok &= check_report("tracker_release_errors", release_errors, 0.0);
+
+    ok &= check_report("tracker_settle_ms", tracker_settle_ms(), CHECK_TRACKER_SETTLE_MS);
+    return ok;
+}
+
+// Formatação: o texto lido de volta fica a meia unidade da última casa
+static bool check_fixed(void) {
+    static const double values[] = {0.0, 0.004, -0.004, 0.005, 1.995, 41.2034, 110.0, 440.125, -12.5, -49.996, 2093.0045, 32767.99};
+    double worst = 0.0;
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        fixed_t value = (fixed_t)lround(values[i] * FIXED_ONE);
+        for (uint8_t decimals = 0; decimals <= 4; decimals++) {
+            char text[24];
+            fixed_append(text, value, decimals);
+            double unit = pow(10.0, -decimals);
+            double err = fabs(strtod(text, NULL) - (double)value / FIXED_ONE) / unit;
+            if (err > worst) worst = err;
+        }
+    }
+    return check_report("fixed_append_units", worst, 0.5);
+}
+
+// Estrobo: corda a poucos cents da nota alvo, processada em blocos de 512
+static bool check_strobe(void) {
+    static const double targets[] = {55.0, 110.0, 196.0, 440.0};
+    static const double offsets[] = {-20.0, -3.0, 0.0, 0.5, 7.0};
+    double worst = 0.0;
+    for (size_t t = 0; t < sizeof(targets) / sizeof(targets[0]); t++) {
+        for (size_t o = 0; o < sizeof(offsets) / sizeof(offsets[0]); o++) {
+            uint32_t total = 32 * 512;  // ~4 s a 4 kHz
+            make_signal(bench_raw, total, 4000, (float)(targets[t] * pow(2.0, offsets[o] / 1200.0)));
+            strobe_init(&bench_strobe, 4000);
+            strobe_set_target(&bench_strobe, (fixed_t)lround(targets[t] * FIXED_ONE));
+            for (uint32_t i = 0; i < total; i += 512) strobe_process(&bench_strobe, bench_raw + i, 512);
+
+            strobe_reading_t reading;
+            double err = strobe_read(&bench_strobe, &reading) ? fabs(to_float(reading.cents) - offsets[o]) : 100.0;
+            if (err > worst) worst = err;
+        }
+    }
+    return check_report("strobe_cents", worst, CHECK_STROBE_CENTS);
+}
+
+// Cordas: as seis soando juntas (fundamental e 2º harmônico), cada uma com seu
+// desvio. Sem o 3º harmônico: o de E2 cai a 2 cents de B3 e não se separa em 128 ms.
+static bool check_strum(void) {
+    static const double strum_offsets[STRUM_STRINGS] = {12.0, -6.0, 0.0, 3.5, -2.0, 8.0};
+    uint32_t total = 32 * 512;  // ~4 s a 4 kHz
+    memset(bench_synth, 0, total * sizeof(double));
+    for (uint32_t s = 0; s < STRUM_STRINGS; s++) {
+        double f = 440.0 * pow(2.0, (strum_standard_tuning[s] - 69 + strum_offsets[s] / 100.0) / 12.0);
+        synth_t sy = {f, 4000, {120.0, 60.0}, {(double)s, 2.0 * s}, 0.0};
+        synth_add(&sy, bench_synth, total);
+    }
+    srand(1);
+    synth_adc(bench_synth, bench_raw, total, 2048.0, 20);
+
+    strum_init(&bench_strum, 4000);
+    for (uint32_t i = 0; i < total; i += 512) strum_process(&bench_strum, bench_raw + i, 512);
+    double worst = 0.0;
+    for (uint32_t s = 0; s < STRUM_STRINGS; s++) {
+        const strum_string_t *string = &bench_strum.reading.strings[s];
+        double err = string->valid ? fabs(to_float(string->cents) - strum_offsets[s]) : 100.0;
+        if (err > worst) worst = err;
+    }
+    bool ok = check_report("strum_cents", worst, CHECK_STRUM_CENTS);
+
+    // Pela análise, com as etapas opcionais desligadas por 4 s (fora dos modos Estrobo e
+    // Cordas): nenhuma leitura. Religado, o banco recomeça e converge como acima.
+    static analysis_t an;
+    analysis_init(&an, 4000, 53);
+    analysis_set_profile(&an, profile_get(PROFILE_GUITAR), 512);
+    analysis_set_stages(&an, 0);
+    analysis_result_t result;
+    uint32_t stage_errors = 0;
+    for (uint32_t i = 0; i < total; i += 512) {
+        analysis_process(&an, bench_raw + i, 512, i / 512, &result);
+        if (result.strum.count != 0 || result.strobe.valid) stage_errors++;
+    }
+    analysis_set_stages(&an, ANALYSIS_STRUM);
+    for (uint32_t i = 0; i < total; i += 512) analysis_process(&an, bench_raw + i, 512, i / 512, &result);
+    worst = (result.strum.count == STRUM_STRINGS) ? 0.0 : 100.0;
+    for (uint32_t s = 0; s < result.strum.count; s++) {
+        const strum_string_t *string = &result.strum.strings[s];
+        double err = string->valid ? fabs(to_float(string->cents) - strum_offsets[s]) : 100.0;
+        if (err > worst) worst = err;
+    }
+    ok &= check_report("analysis_stage_errors", stage_errors, 0.0);
+    ok &= check_report("strum_restart_cents", worst, CHECK_STRUM_CENTS);
+    return ok;
+}
+
+// Tom de referência: a frequência tocada é exata dada a fração do timer de DMA
+static bool check_tone(void) {
+    static const double a4_refs[] = {432.0, 440.0, 442.0};
+    static const uint32_t clocks[] = {125000000, 128000000};
+    double worst = 0.0;
+    for (size_t a = 0; a < sizeof(a4_refs) / sizeof(a4_refs[0]); a++) {
+        note_map_set_reference((fixed_t)lround(a4_refs[a] * FIXED_ONE));
+        for (size_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++) {
+            for (uint8_t midi = NOTE_MAP_MIN_MIDI; midi <= NOTE_MAP_MAX_MIDI; midi++) {
+                tone_plan_t plan;
+                double target = a4_refs[a] * pow(2.0, (midi - NOTE_MAP_A4_MIDI) / 12.0);
+                double err = 100.0;
+                if (tone_plan(note_map_frequency(midi), clocks[c], &plan)) {
+                    err = fabs((double)clocks[c] * plan.num * plan.cycles / ((double)plan.den * plan.points) - target);
+                }
+                if (err > worst) worst = err;
+            }
+        }
+    }
+    note_map_set_reference(NOTE_MAP_DEFAULT_A4);
+    return check_report("tone_frequency_hz", worst, CHECK_TONE_HZ);
+}
+
+// Gravação: ida e volta do empacotamento em 12 bits (contagem par e ímpar)
+static bool check_record(void) {
+    static const uint16_t record_counts[] = {RECORD_MAX_SAMPLES, 1023, 64, 1};
+    static uint16_t raw[RECORD_MAX_SAMPLES], decoded[RECORD_MAX_SAMPLES];
+    static uint8_t frame[RECORD_MAX_FRAME];
+    uint32_t errors = 0;
+    srand(7);
+    for (size_t c = 0; c < sizeof(record_counts) / sizeof(record_counts[0]); c++) {
+        uint16_t count = record_counts[c];
+        for (uint32_t i = 0; i < count; i++) raw[i] = (uint16_t)(rand() & 0x0FFF);
+        size_t size = record_pack(raw, count, 1000 + (uint32_t)c, 64000, frame);
+        record_header_t header;
+        if (size != RECORD_FRAME_SIZE((size_t)count) ||
+            record_unpack(frame, size, &header, decoded) != (int)size ||
+            header.count != count || header.seq != 1000 + c || header.sample_rate != 64000) {
+            errors++;
+            continue;
+        }
+        for (uint32_t i = 0; i < count; i++) errors += decoded[i] != raw[i];
+        if (record_unpack(frame, size - 1, &header, decoded) != 0) errors++;  // Incompleto
+        frame[RECORD_HEADER_SIZE + count / 2] ^= 0x10;
+        if (record_unpack(frame, size, &header, decoded) != -1) errors++;     // Corrompido
+    }
+    return check_report("record_roundtrip_errors", errors, 0.0);
+}
+
+// Nível: microfone polarizado em 1900 (não 2048), blocos de 512 a 4 kHz. Ruído de
+// +-20 por 2 s, nota de 110 Hz (RMS ~212) por 1 s, a mesma nota 9 dB mais fraca por
+// 1 s (acima do fechamento, abaixo da abertura) e de novo o ruído por 1 s.
+static bool check_level(void) {
+    static const double level_gains[] = {0.0, 1.0, 0.355, 0.0};
+    static const uint32_t level_blocks[] = {16, 8, 8, 8};
+    static const bool level_open[] = {false, true, true, false};
+    static uint16_t buffer[512];
+    static int16_t centered[512];
+    static double v[512];
+    level_t level;
+    level_init(&level, 4000, 53);
+    double worst_dc = 0.0, worst_rms = 0.0;
+    uint32_t gate_errors = 0;
+    synth_t sy = synth_sine(110.0, 4000, 300.0);
+    srand(3);
+    for (size_t phase = 0; phase < sizeof(level_gains) / sizeof(level_gains[0]); phase++) {
+        sy.amps[0] = level_gains[phase] * 300.0;
+        for (uint32_t b = 0; b < level_blocks[phase]; b++) {
+            memset(v, 0, sizeof(v));
+            synth_add(&sy, v, 512);
+            synth_adc(v, buffer, 512, 1900.0, 20);
+            double energy = 0.0;
+            for (uint32_t i = 0; i < 512; i++) energy += ((double)buffer[i] - 1900.0) * ((double)buffer[i] - 1900.0);
+
+            level_reading_t reading;
+            bool open = level_process(&level, buffer, 512, centered, &reading);
+            // A porta deve mudar já no primeiro bloco de cada trecho
+            gate_errors += open != level_open[phase];
+            if (b < level_blocks[phase] / 2 || phase == 0) continue;  // DC e RMS depois de acomodar
+            double err_rms = fabs(reading.rms - sqrt(energy / 512));
+            if (err_rms > worst_rms) worst_rms = err_rms;
+            double err_dc = fabs((double)reading.dc - 1900.0);
+            if (err_dc > worst_dc) worst_dc = err_dc;
+        }
+    }
+    bool ok = true;
+    ok &= check_report("level_dc_counts", worst_dc, CHECK_LEVEL_DC);
+    ok &= check_report("level_rms_counts", worst_rms, CHECK_LEVEL_RMS);
+    ok &= check_report("level_gate_errors", gate_errors, 0.0);
+    return ok;
+}
+
+// Botões como no firmware: as bordas entram pela "interrupção" e o alarme roda o
+// debouncer quando vence. Cada mudança de nível repica (três bordas em 0,6 ms). O botão
+// 0 dá dois toques a 60 ms um do outro, o 1 tem um pulso de ruído de 2 ms e o 2 fica
+// seguro por 1 s. O primeiro alarme falha ao armar (sem alarme livre no timer): a borda
+// seguinte o arma. Conta os eventos diferentes dos esperados, os que saem mais de
+// BUTTON_TICK_MS depois do instante esperado e o alarme ainda armado no fim.
+typedef struct {
+    uint32_t t_us;
+    uint8_t button;
+    bool pressed;
+} bench_edge_t;
+
+static uint32_t buttons_event_errors(void) {
+    static const bench_edge_t changes[] = {
+        {0, 0, true}, {40000, 0, false}, {60000, 0, true}, {100000, 0, false},
+        {200000, 1, true}, {202000, 1, false},
+        {300000, 2, true}, {1300000, 2, false},
+    };
+    static const button_event_t expected[] = {
+        {10600, 0, BUTTON_PRESS}, {50600, 0, BUTTON_RELEASE}, {70600, 0, BUTTON_PRESS},
+        {110600, 0, BUTTON_RELEASE}, {310600, 2, BUTTON_PRESS}, {910600, 2, BUTTON_LONG},
+        {1060600, 2, BUTTON_REPEAT}, {1210600, 2, BUTTON_REPEAT}, {1310600, 2, BUTTON_RELEASE},
+    };
+    enum { CHANGES = sizeof(changes) / sizeof(changes[0]), EXPECTED = sizeof(expected) / sizeof(expected[0]) };
+
+    // Cada mudança vira a borda, a volta e a borda de novo, a 300 us uma da outra
+    bench_edge_t edges[3 * CHANGES];
+    uint32_t count = 0;
+    for (uint32_t c = 0; c < CHANGES; c++) {
+        for (uint32_t k = 0; k < 3; k++) {
+            if (changes[c].button == 1 && k > 0) break;  // O pulso de ruído não repica
+            edges[count++] = (bench_edge_t){changes[c].t_us + 300 * k, changes[c].button,
+                                            (k == 1) ? !changes[c].pressed : changes[c].pressed};
+        }
+    }
+
+    static buttons_t bt;
+    buttons_init(&bt, 3);
+    uint64_t alarm = UINT64_MAX;
+    uint32_t next_edge = 0, seen = 0, errors = 0;
+    bool alarm_fails = true;
+    while (next_edge < count || alarm != UINT64_MAX) {
+        uint64_t edge_t = (next_edge < count) ? edges[next_edge].t_us : UINT64_MAX;
+        if (edge_t <= alarm) {
+            const bench_edge_t *e = &edges[next_edge++];
+            if (buttons_edge(&bt, e->button, e->pressed, e->t_us)) {
+                if (alarm_fails) {
+                    buttons_alarm_failed(&bt);
+                    alarm_fails = false;
+                } else {
+                    alarm = e->t_us + BUTTON_DEBOUNCE_MS * 1000;
+                }
+            }
+        } else {
+            uint32_t delay = buttons_update(&bt, (uint32_t)alarm);
+            alarm = (delay > 0) ? alarm + delay : UINT64_MAX;
+        }
+
+        button_event_t event;
+        while (buttons_next(&bt, &event)) {
+            if (seen >= EXPECTED || event.button != expected[seen].button || event.action != expected[seen].action ||
+                event.t_us < expected[seen].t_us || event.t_us > expected[seen].t_us + BUTTON_TICK_MS * 1000) {
+                errors++;
+            }
+            seen++;
+        }
+    }
+    errors += (seen > EXPECTED) ? 0 : EXPECTED - seen;
+    errors += !bt.idle;
+    return errors;
+}
+
+
+static bool check_buttons(void) {
+    return check_report("buttons_event_errors", buttons_event_errors(), 0.0);
+}
+
+// ---------------------------------------------------------------------------
+// Reprodução de uma gravação (--replay)
+
+#define REPLAY_RATE 4000                  // Mesmo SAMPLE_RATE do firmware
+#define REPLAY_BLOCK 512                  // Mesmo BUFFER_SIZE do firmware
+#define REPLAY_THRESHOLD 53               // Mesmo VOLUME_THRESHOLD do firmware (RMS)
+
+static int replay(const char *path) {
+    uint32_t rate = 0, count = 0;
+    uint16_t *adc = wav_read_adc(path, &rate, &count);
+    if (!adc) {
+        fprintf(stderr, "não foi possível ler %s (WAV PCM 16 bits mono)\n", path);
+        return 1;
+    }
+
+    static decimator_t decimator;
+    bool decimate = rate != REPLAY_RATE;
+    if (decimate && !decimator_init(&decimator, rate, REPLAY_RATE)) {
+        fprintf(stderr, "taxa de %u Hz não decima para %u Hz\n", (unsigned)rate, REPLAY_RATE);
+        free(adc);
+        return 1;
+    }
+    uint32_t ratio = decimate ? rate / REPLAY_RATE : 1;
+
+    static analysis_t an;
+    analysis_init(&an, REPLAY_RATE, REPLAY_THRESHOLD);
+    analysis_set_profile(&an, profile_get(PROFILE_CHROMATIC), REPLAY_BLOCK);
+
+    printf("block,time_s,rms,noise_floor,frequency_hz,note,cents\n");
+    static uint16_t block[REPLAY_BLOCK + 1];
+    uint32_t filled = 0, blocks = 0;
+    for (uint32_t pos = 0; pos < count;) {
+        // Entrada em múltiplos da razão: cada chamada rende exatamente n / razão amostras
+        uint32_t n = (REPLAY_BLOCK - filled) * ratio;
+        if (n > count - pos) n = count - pos;
+        if (decimate) {
+            filled += decimator_process(&decimator, adc + pos, n, block + filled);
+        } else {
+            memcpy(block + filled, adc + pos, n * sizeof(uint16_t));
+            filled += n;
+        }
+        pos += n;
+        if (filled < REPLAY_BLOCK) continue;
+
+        analysis_result_t result;
+        analysis_process(&an, block, REPLAY_BLOCK, blocks, &result);
+        blocks++;
+        filled = 0;
+
+        char name[8] = "-";
+        if (result.active && result.in_range) note_map_format(&result.note, name);
+        printf("%u,%.3f,%u,%u,%.3f,%s,%.2f\n", (unsigned)blocks - 1, (double)blocks * REPLAY_BLOCK / REPLAY_RATE,
+               (unsigned)result.amplitude, (unsigned)result.noise_floor, result.active ? to_float(result.frequency) : 0.0,
+               name, (result.active && result.in_range) ? to_float(result.note.cents) : 0.0);
+    }
+    free(adc);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    uint64_t min_ns = 200ull * 1000000ull;
+    const char *filter = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--min-ms") == 0 && i + 1 < argc) {
+            min_ns = strtoull(argv[++i], NULL, 10) * 1000000ull;
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            return replay(argv[++i]);
+        } else {
+            fprintf(stderr, "uso: %s [--min-ms N] [--filter rotina] [--replay arquivo.wav]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    static const uint32_t sizes[] = {512, 1024, 2048};
+    static const uint32_t rates[] = {4000, 8000, 16000};
+    static uint16_t buffer[2048];
+    volatile float sink = 0.0f;
+
+    // Conferências de cada módulo antes das medições
+    bool ok = true;
+    ok &= check_capture();
+    ok &= check_pitch();
+    ok &= check_tuner();
+    ok &= check_note_map();
+    ok &= check_profiles();
+    ok &= check_tracker();
+    ok &= check_fixed();
+    ok &= check_strobe();
+    ok &= check_strum();
+    ok &= check_tone();
+    ok &= check_record();
+    ok &= check_level();
+    ok &= check_buttons();
+    if (!ok) return 1;
+
+    printf("routine,buffer_size,sample_rate,ns_per_frame,frames_per_s,allocs_per_frame\n");
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+            static int16_t centered[2048];
+            bench_input_t in = {buffer, centered, sizes[s], rates[r]};
+            make_signal(buffer, in.size, in.sample_rate, 110.0f);
+            center_block(buffer, in.size, centered);
+            level_init(&bench_level, in.sample_rate, 53);
+            tracker_init(&bench_tracker, in.sample_rate);
+            tuner_init(in.size);
+            fft_plan_init(&bench_plan, (uint16_t)in.size);
+            pitch_stream_init(&bench_stream, in.size, BENCH_HOP, in.sample_rate, MIN_DETECT_FREQ, MAX_DETECT_FREQ);
+            stream_pos = 0;
+            make_signal(bench_raw, in.size * BENCH_OVERSAMPLING, in.sample_rate * BENCH_OVERSAMPLING, 110.0f);
+            decimator_init(&bench_decimator, in.sample_rate * BENCH_OVERSAMPLING, in.sample_rate);
+            strobe_init(&bench_strobe, in.sample_rate);
+            strobe_set_target(&bench_strobe, FIXED_FROM_INT(110));
+            strum_init(&bench_strum, in.sample_rate);
+
+            for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+                if (filter && strcmp(filter, cases[c].name) != 0) continue;
+
+                // Aquecimento
+                for (int w = 0; w < 10; w++) sink += cases[c].run(&in);
+
+                unsigned long allocs_before = alloc_count;
+                uint64_t iterations = 0;
+                uint64_t start = now_ns();
+                uint64_t elapsed;
+                do {
+                    for (int k = 0; k < 16; k++) sink += cases[c].run(&in);
+                    iterations += 16;
+                    elapsed = now_ns() - start;
+                } while (elapsed < min_ns);
+
+                double ns_per_frame = (double)elapsed / (double)iterations;
+                printf("%s,%u,%u,%.1f,%.1f,%.3f\n", cases[c].name, in.size, in.sample_rate,
+                       ns_per_frame, 1e9 / ns_per_frame,
+                       (double)(alloc_count - allocs_before) / (double)iterations);
+            }
+        }
+    }
+
+    (void)sink;
+    return 0;
+}
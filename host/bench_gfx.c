@@ -0,0 +1,387 @@
+// Benchmark nativo das primitivas de desenho do SSD1306.
+//
+// Compara cada primitiva por byte com a versão anterior, que desenhava pixel a pixel
+// (o texto, inclusive ampliado e em rótulos, contra a mesma fonte lida pixel a pixel).
+// hline e o contorno de rect empatam: no quadro em colunas cada coluna da linha é uma
+// leitura-modificação-escrita nas duas versões, e o compilador reduz a por pixel ao
+// mesmo laço.
+// Antes de medir, confere se as duas versões produzem o mesmo framebuffer e se o fluxo
+// I2C do envio por janelas sujas, decodificado como o controlador faria, remonta o quadro,
+// e mede a taxa de acertos do cache de rótulos numa sequência de telas do firmware.
+// Saída CSV: routine,variant,ns_per_call,calls_per_s
+//
+// Opções: --min-ms N (tempo mínimo por medição, padrão 200)
+
+#include "ssd1306.h"
+#include "font.h"
+#include "profiles.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ---------------------------------------------------------------------------
+// Versões por pixel (referência)
+
+static void ref_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+    uint16_t index = (y >> 3) + (x << 3) + 1;
+    uint8_t pixel = (y & 0b111);
+    if (value)
+        ssd->ram_buffer[index] |= (1 << pixel);
+    else
+        ssd->ram_buffer[index] &= ~(1 << pixel);
+}
+
+static void ref_fill(ssd1306_t *ssd, bool value) {
+    for (uint8_t y = 0; y < ssd->height; ++y)
+        for (uint8_t x = 0; x < ssd->width; ++x)
+            ref_pixel(ssd, x, y, value);
+}
+
+static void ref_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
+    for (uint8_t x = x0; x <= x1; ++x)
+        ref_pixel(ssd, x, y, value);
+}
+
+static void ref_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
+    for (uint8_t y = y0; y <= y1; ++y)
+        ref_pixel(ssd, x, y, value);
+}
+
+static void ref_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
+    for (uint8_t x = left; x < left + width; ++x) {
+        ref_pixel(ssd, x, top, value);
+        ref_pixel(ssd, x, top + height - 1, value);
+    }
+    for (uint8_t y = top; y < top + height; ++y) {
+        ref_pixel(ssd, left, y, value);
+        ref_pixel(ssd, left + width - 1, y, value);
+    }
+    if (fill) {
+        for (uint8_t x = left + 1; x < left + width - 1; ++x)
+            for (uint8_t y = top + 1; y < top + height - 1; ++y)
+                ref_pixel(ssd, x, y, value);
+    }
+}
+
+static void ref_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y, uint8_t scale) {
+    const uint8_t *glyph = &font[FONT_GLYPH(c)];
+    for (uint8_t i = 0; i < 8 * scale; ++i)
+        for (uint8_t j = 0; j < 8 * scale; ++j)
+            ref_pixel(ssd, x + i, y + j, glyph[i / scale] & (1 << (j / scale)));
+}
+
+static void ref_draw_scaled(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y, uint8_t scale) {
+    while (*str) {
+        ref_draw_char(ssd, *str++, x, y, scale);
+        x += 8 * scale;
+    }
+}
+
+static void ref_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y) {
+    ref_draw_scaled(ssd, str, x, y, 1);
+}
+
+// ---------------------------------------------------------------------------
+// Casos: cada um tem a versão por pixel e a versão por byte
+
+typedef void (*draw_fn_t)(ssd1306_t *ssd);
+
+typedef struct {
+    const char *name;
+    draw_fn_t per_pixel;
+    draw_fn_t per_byte;
+} gfx_case_t;
+
+static void pp_fill(ssd1306_t *s) { ref_fill(s, true); }
+static void pb_fill(ssd1306_t *s) { ssd1306_fill(s, true); }
+static void pp_hline(ssd1306_t *s) { ref_hline(s, 0, 127, 37, true); }
+static void pb_hline(ssd1306_t *s) { ssd1306_hline(s, 0, 127, 37, true); }
+static void pp_vline(ssd1306_t *s) { ref_vline(s, 50, 3, 60, true); }
+static void pb_vline(ssd1306_t *s) { ssd1306_vline(s, 50, 3, 60, true); }
+static void pp_rect(ssd1306_t *s) { ref_rect(s, 0, 0, 128, 16, true, false); }
+static void pb_rect(ssd1306_t *s) { ssd1306_rect(s, 0, 0, 128, 16, true, false); }
+static void pp_rect_fill(ssd1306_t *s) { ref_rect(s, 5, 10, 100, 40, true, true); }
+static void pb_rect_fill(ssd1306_t *s) { ssd1306_rect(s, 5, 10, 100, 40, true, true); }
+static void pp_text(ssd1306_t *s) { ref_draw_string(s, "Modo Afinador", 16, 4); }
+static void pb_text(ssd1306_t *s) { ssd1306_draw_string(s, "Modo Afinador", 16, 4); }
+static void pp_text_aligned(ssd1306_t *s) { ref_draw_string(s, "Modo Afinador", 16, 8); }
+static void pb_text_aligned(ssd1306_t *s) { ssd1306_draw_string(s, "Modo Afinador", 16, 8); }
+static void pb_label(ssd1306_t *s) { ssd1306_draw_label(s, "Modo Afinador", 16, 4); }
+static void pb_label_aligned(ssd1306_t *s) { ssd1306_draw_label(s, "Modo Afinador", 16, 8); }
+static void pp_symbols(ssd1306_t *s) { ref_draw_string(s, "A#2: -12c 5%", 8, 40); }
+static void pb_symbols(ssd1306_t *s) { ssd1306_draw_string(s, "A#2: -12c 5%", 8, 40); }
+static void pp_digits(ssd1306_t *s) { ref_draw_scaled(s, "440.0", 20, 16, 2); }
+static void pb_digits(ssd1306_t *s) { ssd1306_draw_string_scaled(s, "440.0", 20, 16, 2); }
+static void pp_digits_offset(ssd1306_t *s) { ref_draw_scaled(s, "-12.3c", 0, 21, 2); }
+static void pb_digits_offset(ssd1306_t *s) { ssd1306_draw_string_scaled(s, "-12.3c", 0, 21, 2); }
+static void pp_digits_x3(ssd1306_t *s) { ref_draw_scaled(s, "82.4", 10, 13, 3); }
+static void pb_digits_x3(ssd1306_t *s) { ssd1306_draw_string_scaled(s, "82.4", 10, 13, 3); }
+
+static const gfx_case_t cases[] = {
+    {"fill", pp_fill, pb_fill},
+    {"hline", pp_hline, pb_hline},
+    {"vline", pp_vline, pb_vline},
+    {"rect", pp_rect, pb_rect},
+    {"rect_filled", pp_rect_fill, pb_rect_fill},
+    {"draw_string", pp_text, pb_text},
+    {"draw_string_aligned", pp_text_aligned, pb_text_aligned},
+    {"draw_label", pp_text, pb_label},
+    {"draw_label_aligned", pp_text_aligned, pb_label_aligned},
+    {"draw_string_symbols", pp_symbols, pb_symbols},
+    {"draw_digits_x2", pp_digits, pb_digits},
+    {"draw_digits_x2_offset", pp_digits_offset, pb_digits_offset},
+    {"draw_digits_x3", pp_digits_x3, pb_digits_x3},
+};
+
+// ---------------------------------------------------------------------------
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Fundo pseudoaleatório, para que máscaras e bits preservados sejam exercitados
+static void noise(ssd1306_t *ssd) {
+    srand(7);
+    for (size_t i = 1; i < ssd->bufsize; i++)
+        ssd->ram_buffer[i] = (uint8_t)rand();
+}
+
+// ---------------------------------------------------------------------------
+// Envio por janelas sujas: decodifica tx_words como o SSD1306 (endereçamento vertical)
+
+#define STREAM_STOP 0x200u  // Bit de STOP de IC_DATA_CMD
+
+typedef struct {
+    uint8_t screen[WIDTH * HEIGHT / 8];  // Mesmo leiaute de ram_buffer + 1
+    uint8_t c0, c1, p0, p1;              // Janela de SET_COL_ADDR / SET_PAGE_ADDR
+    uint8_t col, page;                   // Ponteiro de escrita
+    uint32_t bus_bytes;                  // Bytes no barramento, com o de endereço
+} panel_t;
+
+// Aplica o fluxo de um envio ao painel; false se o fluxo estiver malformado
+static bool panel_apply(panel_t *panel, const ssd1306_t *ssd) {
+    const uint8_t pages = HEIGHT / 8;
+    panel->bus_bytes = 0;
+    if (ssd->tx_len > ssd->tx_capacity) return false;
+    for (size_t k = 0; k < ssd->tx_len; k++) {
+        if (ssd->tx_words[k] & ~(STREAM_STOP | 0xFFu)) return false;  // Só dado e STOP para o IC_DATA_CMD
+    }
+    size_t i = 0;
+    while (i < ssd->tx_len) {
+        // Uma transação vai até a palavra com STOP
+        size_t end = i;
+        while (end < ssd->tx_len && !(ssd->tx_words[end] & STREAM_STOP)) end++;
+        if (end == ssd->tx_len) return false;  // Transação sem STOP no fim
+        panel->bus_bytes += 1 + (uint32_t)(end + 1 - i);
+
+        uint16_t control = ssd->tx_words[i];
+        if (control == 0x00) {
+            if (end - i != 6) return false;
+            uint8_t cmd[6];
+            for (size_t k = 0; k < 6; k++) cmd[k] = (uint8_t)ssd->tx_words[i + 1 + k];
+            if (cmd[0] != 0x21 || cmd[3] != 0x22) return false;
+            panel->c0 = cmd[1];
+            panel->c1 = cmd[2];
+            panel->p0 = cmd[4];
+            panel->p1 = cmd[5];
+            if (panel->c1 >= WIDTH || panel->p1 >= pages || panel->c0 > panel->c1 || panel->p0 > panel->p1)
+                return false;
+            panel->col = panel->c0;
+            panel->page = panel->p0;
+        } else if (control == 0x40) {
+            for (size_t k = i + 1; k <= end; k++) {
+                panel->screen[panel->col * pages + panel->page] = (uint8_t)ssd->tx_words[k];
+                if (++panel->page > panel->p1) {
+                    panel->page = panel->p0;
+                    if (++panel->col > panel->c1) panel->col = panel->c0;
+                }
+            }
+        } else {
+            return false;
+        }
+        i = end + 1;
+    }
+    return true;
+}
+
+// Envia o quadro, espera o barramento e confere o painel decodificado e os bytes
+static int check_flush(ssd1306_t *ssd, panel_t *panel, uint32_t expected_bytes, const char *step) {
+    ssd1306_send_data(ssd);
+    ssd1306_wait(ssd);
+    int errors = 0;
+    if (!panel_apply(panel, ssd)) {
+        fprintf(stderr, "stream %s: fluxo I2C malformado\n", step);
+        errors++;
+    }
+    if (memcmp(panel->screen, ssd->ram_buffer + 1, sizeof(panel->screen)) != 0) {
+        fprintf(stderr, "stream %s: painel decodificado difere do framebuffer\n", step);
+        errors++;
+    }
+    if (ssd->bytes_sent != expected_bytes || panel->bus_bytes != expected_bytes) {
+        fprintf(stderr, "stream %s: %u bytes enviados (fluxo: %u), esperado %u\n", step,
+                (unsigned)ssd->bytes_sent, (unsigned)panel->bus_bytes, (unsigned)expected_bytes);
+        errors++;
+    }
+    return errors;
+}
+
+// Tamanho no barramento de uma janela: comandos (1 + 7) e dados (1 + 1 + colunas x páginas)
+static uint32_t window_bytes(uint32_t cols, uint32_t pages) {
+    return (1 + 7) + (1 + 1 + cols * pages);
+}
+
+static int check_stream(void) {
+    ssd1306_t ssd;
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, NULL);
+    static panel_t panel;
+    memset(&panel, 0, sizeof(panel));
+    const uint8_t pages = HEIGHT / 8;
+
+    // Primeiro envio: a tela inteira
+    noise(&ssd);
+    int errors = check_flush(&ssd, &panel, window_bytes(WIDTH, pages), "inteiro");
+
+    // Colunas 10 e 12 (páginas 2 e 3) ficam numa janela só (vão <= SSD1306_MERGE_GAP);
+    // a coluna 100 (página 7) abre outra
+    ssd.ram_buffer[1 + 10 * pages + 2] ^= 0x81;
+    ssd.ram_buffer[1 + 12 * pages + 3] ^= 0x18;
+    ssd.ram_buffer[1 + 100 * pages + 7] ^= 0xFF;
+    errors += check_flush(&ssd, &panel, window_bytes(3, 2) + window_bytes(1, 1), "janelas");
+
+    // Texto sobre o quadro: confere só o painel e o tamanho informado pelo fluxo
+    ssd1306_draw_string(&ssd, "A4 440", 30, 20);
+    ssd1306_send_data(&ssd);
+    ssd1306_wait(&ssd);
+    if (!panel_apply(&panel, &ssd) || panel.bus_bytes != ssd.bytes_sent ||
+        memcmp(panel.screen, ssd.ram_buffer + 1, sizeof(panel.screen)) != 0) {
+        fprintf(stderr, "stream texto: painel decodificado difere do framebuffer\n");
+        errors++;
+    }
+
+    // Colunas sujas a SSD1306_MERGE_GAP + 2 uma da outra, em todas as páginas: uma
+    // janela por coluna, o fluxo mais fragmentado para a DMA
+    uint32_t windows = 0;
+    for (uint16_t x = 0; x < WIDTH; x += SSD1306_MERGE_GAP + 2, windows++) {
+        for (uint8_t p = 0; p < pages; p++) ssd.ram_buffer[1 + x * pages + p] ^= 0x5A;
+    }
+    errors += check_flush(&ssd, &panel, windows * window_bytes(1, pages), "fragmentado");
+
+    // Quadro idêntico: nada vai ao barramento
+    errors += check_flush(&ssd, &panel, 0, "igual");
+    return errors;
+}
+
+// Rótulos de main.c, tela por tela (um rótulo repetido em várias telas é a mesma
+// string, como a literal única do firmware)
+static const char TOUCH[] = "Toque a nota";
+static const char TUNER[] = "Modo Afinador";
+static const char STROBE[] = "Modo Estrobo";
+static const char STRUM[] = "Modo Cordas";
+static const char *const screen_menu[] = {"1: Afinador", "2: Diapasao", "3: Estrobo", "4: Cordas", "5: Perfil", "6: Gravar", NULL};
+static const char *const screen_tuner[] = {TUNER, TOUCH, NULL};
+static const char *const screen_tuner_note[] = {TUNER, "Hz", NULL};
+static const char *const screen_strobe[] = {STROBE, TOUCH, NULL};
+static const char *const screen_strum[] = {STRUM, "Toque as cordas", NULL};
+static const char *const screen_strum_result[] = {STRUM, NULL};
+static const char *const screen_diapason[] = {"Modo Diapasao", NULL};
+static const char *const screen_record[] = {"Modo Gravar", NULL};
+static const char PROFILE[] = "Perfil";
+
+static void draw_screen(ssd1306_t *ssd, const char *const *screen) {
+    for (; *screen; screen++) ssd1306_draw_label(ssd, *screen, 0, 0);
+}
+
+// Taxa de acertos do cache de rótulos numa sessão de uso: percorre o menu, entra em
+// cada modo com algumas telas de resultado e, nos perfis, passa por todos. A primeira
+// volta monta os rótulos; nas seguintes todos já deveriam estar no cache.
+static int check_labels(void) {
+    ssd1306_t ssd;
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, NULL);
+    uint32_t hits0, misses0, hits1, misses1, hits2, misses2;
+    ssd1306_label_stats(&hits0, &misses0);
+    for (int round = 0; round < 10; round++) {
+        if (round == 1) ssd1306_label_stats(&hits1, &misses1);
+        draw_screen(&ssd, screen_menu);
+        draw_screen(&ssd, screen_tuner);
+        for (int i = 0; i < 20; i++) draw_screen(&ssd, screen_tuner_note);
+        draw_screen(&ssd, screen_menu);
+        draw_screen(&ssd, screen_diapason);
+        draw_screen(&ssd, screen_menu);
+        draw_screen(&ssd, screen_strobe);
+        draw_screen(&ssd, screen_menu);
+        draw_screen(&ssd, screen_strum);
+        for (int i = 0; i < 20; i++) draw_screen(&ssd, screen_strum_result);
+        draw_screen(&ssd, screen_menu);
+        for (uint8_t id = 0; id < PROFILE_COUNT; id++) {
+            ssd1306_draw_label(&ssd, PROFILE, 0, 0);
+            ssd1306_draw_label(&ssd, profile_get(id)->name, 0, 0);
+        }
+        draw_screen(&ssd, screen_menu);
+        draw_screen(&ssd, screen_record);
+    }
+    ssd1306_label_stats(&hits2, &misses2);
+
+    uint32_t cold = misses1 - misses0;
+    uint32_t warm_hits = hits2 - hits1, warm_misses = misses2 - misses1;
+    double rate = (double)warm_hits / (warm_hits + warm_misses);
+    printf("label_cache,hit_rate,%.4f,%u\n", rate, (unsigned)cold);  // Quarta coluna: faltas na 1a volta
+    if (warm_misses != 0) {
+        fprintf(stderr, "label_cache: %u faltas na primeira volta e %u depois dela (%d posições)\n",
+                (unsigned)cold, (unsigned)warm_misses, SSD1306_LABEL_SLOTS);
+        return 1;
+    }
+    return 0;
+}
+
+static double measure(ssd1306_t *ssd, draw_fn_t fn, uint64_t min_ns) {
+    uint64_t iterations = 0;
+    uint64_t start = now_ns();
+    uint64_t elapsed;
+    do {
+        for (int k = 0; k < 64; k++) fn(ssd);
+        iterations += 64;
+        elapsed = now_ns() - start;
+    } while (elapsed < min_ns);
+    return (double)elapsed / (double)iterations;
+}
+
+int main(int argc, char **argv) {
+    uint64_t min_ns = 200ull * 1000000ull;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--min-ms") == 0 && i + 1 < argc) {
+            min_ns = strtoull(argv[++i], NULL, 10) * 1000000ull;
+        } else {
+            fprintf(stderr, "uso: %s [--min-ms N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    ssd1306_t a, b;
+    ssd1306_init(&a, WIDTH, HEIGHT, false, 0x3C, NULL);
+    ssd1306_init(&b, WIDTH, HEIGHT, false, 0x3C, NULL);
+
+    printf("routine,variant,ns_per_call,calls_per_s\n");
+
+    int mismatches = check_stream();
+    mismatches += check_labels();
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        noise(&a);
+        noise(&b);
+        cases[c].per_pixel(&a);
+        cases[c].per_byte(&b);
+        if (memcmp(a.ram_buffer, b.ram_buffer, a.bufsize) != 0) {
+            fprintf(stderr, "%s: framebuffer diferente da versão por pixel\n", cases[c].name);
+            mismatches++;
+        }
+
+        double pp = measure(&a, cases[c].per_pixel, min_ns);
+        double pb = measure(&b, cases[c].per_byte, min_ns);
+        printf("%s,per_pixel,%.1f,%.1f\n", cases[c].name, pp, 1e9 / pp);
+        printf("%s,per_byte,%.1f,%.1f\n", cases[c].name, pb, 1e9 / pb);
+    }
+
+    return mismatches ? 1 : 0;
+}
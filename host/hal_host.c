@@ -0,0 +1,655 @@
+// Backend de host da HAL (inc/hal.h): simulador do hardware para rodar o laço do
+// firmware no Linux. Configuração, entradas e saídas em hal_host.h.
+
+#define _GNU_SOURCE  // fopencookie(): a serial passa pelo simulador
+#include "hal.h"
+#include "hal_host.h"
+#include "record.h"
+#include "tone.h"
+#include "ws2812.h"
+#include "wav.h"
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define OLED_US_PER_BYTE 22.5     // 9 bits (8 + ACK) a 400 kHz
+#define SIM_CLOCK_HZ 128000000    // Clock do sistema definido por ws2812Init
+#define SIM_DEFAULT_MS 10000      // Duração sem WAV nem roteiro
+#define SIM_TAIL_MS 500           // Depois do último evento do roteiro, para ver a resposta
+#define SCRIPT_MAX_EVENTS 4096
+#define SIM_CLICK_MS 80           // Botão seguro num toque simples do roteiro
+#define SIM_BOUNCE_US 300         // Intervalo entre as bordas do repique (três por mudança)
+#define CONSOLE_QUEUE 256         // Potência de 2
+#define PENDING_INPUTS 64         // Entradas aguardando o próximo quadro de cada saída
+#define NO_EVENT UINT64_MAX
+
+typedef struct {
+    uint64_t t_us;
+    char kind;                    // 'A', 'B', 'J' (borda), 'k' (tecla), 'm' (marcador), 'e' (fim)
+    bool pressed;                 // Botões: nível depois da borda
+    bool input;                   // Conta como entrada na latência (primeira borda de um aperto)
+    char text[48];
+} script_event_t;
+
+// Latência entre uma entrada e o fim do próximo quadro de uma saída
+typedef struct {
+    uint64_t inputs[PENDING_INPUTS];
+    unsigned int pending;
+    unsigned int count, lost;
+    uint64_t sum_us, min_us, max_us;
+} latency_t;
+
+// Quadros enviados a uma saída e tempo de barramento ocupado
+typedef struct {
+    uint32_t frames;
+    uint64_t bytes, max_bytes;
+    uint64_t busy_us;
+} output_stats_t;
+
+static hal_sim_config_t sim_config;
+static uint64_t now_us = 0;
+static uint64_t end_us = (uint64_t)SIM_DEFAULT_MS * 1000;
+static bool event_pending = false;   // Registrador de eventos do WFE
+static bool in_advance = false;      // Evita reentrada pelas interrupções simuladas
+static struct timespec wall_mark;
+
+// Microfone
+static uint16_t *wav_adc = NULL;
+static uint32_t wav_rate = 0, wav_count = 0;
+static uint16_t *mic = NULL;
+static uint32_t mic_count = 0;
+static capture_t *mic_capture = NULL;
+static uint32_t mic_rate = 0;
+static uint64_t mic_start_us = 0;
+static uint64_t mic_fed = 0;         // Amostras já entregues à captura
+
+// Roteiro
+static script_event_t script[SCRIPT_MAX_EVENTS];
+static unsigned int script_count = 0, script_next = 0;
+
+// Periféricos
+static hal_button_callback_t button_callback = NULL;
+static hal_alarm_callback_t alarm_callback = NULL;
+static uint64_t alarm_us = NO_EVENT;
+static char console_queue[CONSOLE_QUEUE];
+static uint32_t console_head = 0, console_tail = 0;
+static bool console_binary = false;
+
+// Serial: o stdout do firmware, conferido no modo binário
+static FILE *serial_out = NULL;             // stdout real do processo
+static uint8_t serial_pending[2 * RECORD_MAX_FRAME];
+static size_t serial_len = 0;
+static uint64_t serial_binary_bytes = 0;    // Escritos no modo binário (gravação)
+static uint32_t serial_frames = 0;          // Quadros AFRC válidos
+static uint64_t serial_stray = 0;           // Bytes do modo binário fora de um quadro
+static int rgb_state = -1;
+
+// Saídas e relatório
+static FILE *events = NULL;
+static output_stats_t oled_stats, leds_stats;
+static latency_t oled_latency, leds_latency;
+static uint32_t inputs_total = 0;
+
+static void sim_finish(void);
+
+// ---------------------------------------------------------------------------
+// Relógio virtual
+
+// Uma linha de events.csv: t_us,event,value,done_us,data (campos vazios quando não se aplicam)
+static void log_event(const char *event, const char *format, ...) __attribute__((format(printf, 2, 3)));
+static void log_event(const char *event, const char *format, ...) {
+    if (!events) return;
+    fprintf(events, "%llu,%s,", (unsigned long long)now_us, event);
+    va_list args;
+    va_start(args, format);
+    vfprintf(events, format, args);
+    va_end(args);
+    fputc('\n', events);
+}
+
+// Instante em que o próximo bloco do ADC fica completo
+static uint64_t next_block_us(void) {
+    if (!mic_capture) return NO_EVENT;
+    uint64_t target = (mic_fed / CAPTURE_BLOCK_SIZE + 1) * CAPTURE_BLOCK_SIZE;
+    return mic_start_us + (target * 1000000 + mic_rate - 1) / mic_rate;
+}
+
+static uint64_t next_script_us(void) {
+    return (script_next < script_count) ? script[script_next].t_us : NO_EVENT;
+}
+
+static uint64_t next_interrupt_us(void) {
+    uint64_t block = next_block_us(), step = next_script_us();
+    uint64_t next = (block < step) ? block : step;
+    return (alarm_us < next) ? alarm_us : next;
+}
+
+// Entrega à captura as amostras do microfone até o instante atual
+static void feed_mic(void) {
+    static const uint16_t silence[CAPTURE_BLOCK_SIZE] = {[0 ... CAPTURE_BLOCK_SIZE - 1] = 2048};
+    if (!mic_capture) return;
+
+    uint64_t due = (now_us - mic_start_us) * mic_rate / 1000000;
+    while (mic_fed < due) {
+        uint32_t n = (due - mic_fed > CAPTURE_BLOCK_SIZE) ? CAPTURE_BLOCK_SIZE : (uint32_t)(due - mic_fed);
+        uint32_t before = mic_capture->produced;
+        if (mic_fed < mic_count) {
+            if (n > mic_count - mic_fed) n = (uint32_t)(mic_count - mic_fed);
+            capture_feed(mic_capture, &mic[mic_fed], n);
+        } else {
+            capture_feed(mic_capture, silence, n);
+        }
+        mic_fed += n;
+        if (mic_capture->produced != before) event_pending = true;  // Interrupção da DMA
+    }
+}
+
+static void register_input(uint64_t t) {
+    inputs_total++;
+    latency_t *targets[2] = {&oled_latency, &leds_latency};
+    for (int i = 0; i < 2; i++) {
+        latency_t *l = targets[i];
+        if (l->pending < PENDING_INPUTS) l->inputs[l->pending++] = t;
+        else l->lost++;
+    }
+}
+
+// Um quadro terminado em done_us responde a todas as entradas pendentes
+static void resolve_inputs(latency_t *l, uint64_t done_us) {
+    for (unsigned int i = 0; i < l->pending; i++) {
+        uint64_t latency = done_us - l->inputs[i];
+        if (l->count == 0 || latency < l->min_us) l->min_us = latency;
+        if (latency > l->max_us) l->max_us = latency;
+        l->sum_us += latency;
+        l->count++;
+    }
+    l->pending = 0;
+}
+
+static void run_script_event(const script_event_t *e) {
+    switch (e->kind) {
+        case 'A':
+        case 'B':
+        case 'J': {
+            hal_button_t button = (e->kind == 'A') ? HAL_BUTTON_A : (e->kind == 'B') ? HAL_BUTTON_B
+                                                                                   : HAL_BUTTON_JOYSTICK;
+            log_event("button", "%c,,%s", e->kind, e->pressed ? "pressionado" : "solto");
+            if (e->input) register_input(now_us);
+            if (button_callback) button_callback(button, e->pressed);
+            event_pending = true;
+            break;
+        }
+        case 'k':
+            log_event("key", "%.*s,,", (int)strcspn(e->text, "\n"), e->text);
+            register_input(now_us);
+            for (const char *c = e->text; *c != '\0'; c++) {
+                if (console_head - console_tail < CONSOLE_QUEUE)
+                    console_queue[console_head++ & (CONSOLE_QUEUE - 1)] = *c;
+            }
+            event_pending = true;  // A interrupção da USB acorda o WFE
+            break;
+        case 'm':
+            log_event("mark", "%s,,", e->text);
+            break;
+        case 'e':
+            end_us = now_us;
+            break;
+    }
+}
+
+// Avança o relógio até `t`, atendendo na ordem os eventos do caminho
+static void sim_advance(uint64_t t) {
+    if (in_advance) return;
+    in_advance = true;
+    while (true) {
+        uint64_t next = next_interrupt_us();
+        if (next > t || next > end_us) break;
+        now_us = next;
+        feed_mic();
+        if (next == next_script_us()) run_script_event(&script[script_next++]);
+        if (now_us == alarm_us) {
+            // Interrupção do alarme: o retorno do callback o rearma
+            uint32_t delay = alarm_callback ? alarm_callback() : 0;
+            alarm_us = (delay > 0) ? now_us + delay : NO_EVENT;
+            event_pending = true;
+        }
+    }
+    if (t > end_us) t = end_us;
+    if (t > now_us) now_us = t;
+    feed_mic();
+    in_advance = false;
+    if (now_us >= end_us) sim_finish();
+}
+
+// Com cpu_scale, cobra o tempo real gasto pelo laço desde a última chamada
+static void charge_cpu(void) {
+    struct timespec wall;
+    clock_gettime(CLOCK_MONOTONIC, &wall);
+    double elapsed_us = (wall.tv_sec - wall_mark.tv_sec) * 1e6 + (wall.tv_nsec - wall_mark.tv_nsec) / 1e3;
+    wall_mark = wall;
+    if (sim_config.cpu_scale > 0 && !in_advance) sim_advance(now_us + (uint64_t)(elapsed_us * sim_config.cpu_scale));
+}
+
+// Dormir não custa CPU: o relógio real recomeça a contar na volta
+static void sleep_until(uint64_t t) {
+    if (t == NO_EVENT || t > end_us) t = end_us;
+    sim_advance(t);
+    clock_gettime(CLOCK_MONOTONIC, &wall_mark);
+}
+
+// ---------------------------------------------------------------------------
+// HAL
+
+uint64_t hal_time_us(void) {
+    charge_cpu();
+    return now_us;
+}
+
+void hal_busy_wait_until_us(uint64_t deadline_us) {
+    charge_cpu();
+    if (deadline_us > now_us) sim_advance(deadline_us);
+}
+
+void hal_wait_for_event(void) {
+    charge_cpu();
+    if (!event_pending) sleep_until(next_interrupt_us());
+    event_pending = false;
+}
+
+void hal_wait_for_event_timeout_us(uint32_t timeout_us) {
+    charge_cpu();
+    if (!event_pending) {
+        uint64_t next = next_interrupt_us(), timeout = now_us + timeout_us;
+        sleep_until((next < timeout) ? next : timeout);
+    }
+    event_pending = false;
+}
+
+void hal_notify(void) {
+    event_pending = true;
+}
+
+void hal_buttons_init(const unsigned int pins[HAL_BUTTONS], hal_button_callback_t callback) {
+    (void)pins;  // O roteiro nomeia os botões
+    button_callback = callback;
+}
+
+bool hal_alarm_start(uint32_t delay_us, hal_alarm_callback_t callback) {
+    alarm_callback = callback;
+    alarm_us = now_us + delay_us;
+    return true;  // O simulador tem um alarme só, sempre livre
+}
+
+void hal_rgb_init(unsigned int red_pin, unsigned int green_pin, unsigned int blue_pin) {
+    (void)red_pin;
+    (void)green_pin;
+    (void)blue_pin;
+}
+
+void hal_rgb_set(bool red, bool green, bool blue) {
+    int state = (red << 2) | (green << 1) | blue;
+    if (state == rgb_state) return;
+    rgb_state = state;
+    log_event("rgb", "%d%d%d,,", red, green, blue);
+}
+
+void hal_oled_bus_init(i2c_inst_t *port, unsigned int sda_pin, unsigned int scl_pin, uint32_t baudrate) {
+    (void)port;
+    (void)sda_pin;
+    (void)scl_pin;
+    (void)baudrate;
+}
+
+void hal_mic_start(capture_t *capture, unsigned int pin, uint32_t sample_rate) {
+    (void)pin;
+    capture_reset(capture, sample_rate);
+    mic_capture = capture;
+    mic_rate = sample_rate;
+    mic_start_us = now_us;
+    mic_fed = 0;
+
+    // Reamostra o WAV para a taxa do ADC (interpolação linear)
+    free(mic);
+    mic = NULL;
+    mic_count = 0;
+    if (!wav_adc || wav_count == 0) return;
+    mic_count = (uint32_t)((uint64_t)wav_count * sample_rate / wav_rate);
+    mic = malloc(mic_count * sizeof(uint16_t));
+    for (uint32_t i = 0; i < mic_count; i++) {
+        double pos = (double)i * wav_rate / sample_rate;
+        uint32_t k = (uint32_t)pos;
+        double frac = pos - k;
+        uint16_t a = wav_adc[k], b = (k + 1 < wav_count) ? wav_adc[k + 1] : a;
+        mic[i] = (uint16_t)lround(a + (b - a) * frac);
+    }
+}
+
+void hal_console_init(void) {
+    clock_gettime(CLOCK_MONOTONIC, &wall_mark);
+}
+
+int hal_console_getc(void) {
+    if (console_head == console_tail) return -1;
+    return (unsigned char)console_queue[console_tail++ & (CONSOLE_QUEUE - 1)];
+}
+
+// Consome os quadros completos de serial_pending; `end` fecha o trecho binário e conta o
+// que sobrou (quadro truncado) como fora de quadro
+static void serial_decode(bool end) {
+    static uint16_t samples[RECORD_MAX_SAMPLES];
+    size_t pos = 0;
+    while (pos < serial_len) {
+        record_header_t header;
+        int size = record_unpack(serial_pending + pos, serial_len - pos, &header, samples);
+        if (size == 0) break;
+        if (size < 0) {
+            pos++;  // Texto ou lixo no meio da gravação
+            serial_stray++;
+            continue;
+        }
+        pos += (size_t)size;
+        serial_frames++;
+    }
+    if (end) {
+        serial_stray += serial_len - pos;
+        pos = serial_len;
+    }
+    memmove(serial_pending, serial_pending + pos, serial_len - pos);
+    serial_len -= pos;
+}
+
+// Escrita do stdout do firmware: repassa ao stdout real e, no modo binário, decodifica
+// como o record_to_wav. Um quadro incompleto ocupa menos de RECORD_MAX_FRAME, então
+// sempre cabe mais um pedaço.
+static ssize_t serial_write(void *cookie, const char *data, size_t len) {
+    (void)cookie;
+    fwrite(data, 1, len, serial_out);
+    if (!console_binary) return (ssize_t)len;
+    serial_binary_bytes += len;
+    for (size_t done = 0; done < len;) {
+        size_t n = sizeof(serial_pending) - serial_len;
+        if (n > len - done) n = len - done;
+        memcpy(serial_pending + serial_len, data + done, n);
+        serial_len += n;
+        done += n;
+        serial_decode(false);
+    }
+    return (ssize_t)len;
+}
+
+void hal_console_binary(bool binary) {
+    fflush(stdout);  // O texto anterior não entra no trecho binário (e vice-versa)
+    if (console_binary && !binary) serial_decode(true);
+    console_binary = binary;  // stdout do host não traduz \n
+}
+
+void hal_console_write(const void *data, size_t len) {
+    fwrite(data, 1, len, stdout);
+}
+
+// ---------------------------------------------------------------------------
+// Registradores virtuais
+
+// Grava a tela (layout do SSD1306: coluna a coluna, uma página por byte) em PBM
+static void write_pbm(const uint8_t *screen, uint8_t width, uint8_t pages, uint32_t index) {
+    if (!sim_config.out_dir) return;
+    char path[512];
+    snprintf(path, sizeof(path), "%s/oled_%05u.pbm", sim_config.out_dir, (unsigned)index);
+    FILE *f = fopen(path, "wb");
+    if (!f) return;
+    fprintf(f, "P4\n%u %u\n", (unsigned)width, (unsigned)pages * 8);
+    for (unsigned int y = 0; y < pages * 8u; y++) {
+        for (unsigned int x = 0; x < width; x += 8) {
+            uint8_t bits = 0;
+            for (unsigned int b = 0; b < 8 && x + b < width; b++) {
+                if (screen[(x + b) * pages + y / 8] & (1 << (y % 8))) bits |= 0x80 >> b;
+            }
+            fputc(bits, f);
+        }
+    }
+    fclose(f);
+}
+
+uint64_t hal_sim_oled_transfer(const uint8_t *screen, uint8_t width, uint8_t pages, size_t bus_bytes) {
+    uint64_t duration = (uint64_t)ceil(bus_bytes * OLED_US_PER_BYTE);
+    uint64_t done = hal_time_us() + duration;
+
+    oled_stats.frames++;
+    oled_stats.bytes += bus_bytes;
+    if (bus_bytes > oled_stats.max_bytes) oled_stats.max_bytes = bus_bytes;
+    oled_stats.busy_us += duration;
+    resolve_inputs(&oled_latency, done);
+
+    write_pbm(screen, width, pages, oled_stats.frames);
+    log_event("oled", "%zu,%llu,oled_%05u.pbm", bus_bytes, (unsigned long long)done, (unsigned)oled_stats.frames);
+    return done;
+}
+
+uint64_t hal_sim_leds_transfer(const uint32_t *grb, unsigned int count) {
+    uint64_t duration = (uint64_t)count * WS2812_PIXEL_US + WS2812_RESET_US;
+    uint64_t done = hal_time_us() + duration;
+
+    leds_stats.frames++;
+    leds_stats.bytes += count * 3u;
+    if (count * 3u > leds_stats.max_bytes) leds_stats.max_bytes = count * 3u;
+    leds_stats.busy_us += duration;
+    resolve_inputs(&leds_latency, done);
+
+    // Cores na ordem da cadeia, em GRB hexadecimal
+    char colors[WS2812_PIXELS * 7 + 1] = "";
+    size_t len = 0;
+    for (unsigned int i = 0; i < count && i < WS2812_PIXELS; i++)
+        len += snprintf(colors + len, sizeof(colors) - len, "%s%06x", i ? " " : "", (unsigned)(grb[i] >> 8));
+    log_event("leds", "%u,%llu,%s", count * 3u, (unsigned long long)done, colors);
+    return done;
+}
+
+// Buzzer: sem PWM no host, só o plano do tom (com o clock do firmware) e o evento
+bool tone_start(unsigned int gpio, fixed_t frequency, uint16_t amplitude, tone_plan_t *plan) {
+    (void)gpio;
+    (void)amplitude;
+    bool ok = tone_plan(frequency, SIM_CLOCK_HZ, plan);
+    if (ok) log_event("tone", "%.4f,,", plan->frequency / (double)FIXED_ONE);
+    else log_event("tone", "fora do alcance,,");
+    return ok;
+}
+
+void tone_stop(void) {
+    log_event("tone", "desligado,,");
+}
+
+// ---------------------------------------------------------------------------
+// Configuração e relatório
+
+// Insere mantendo a ordem do tempo (depois dos eventos do mesmo instante): as bordas
+// geradas por um toque podem cair depois de linhas seguintes do roteiro
+static bool script_add(const script_event_t *e) {
+    if (script_count == SCRIPT_MAX_EVENTS) return false;
+    unsigned int i = script_count++;
+    while (i > 0 && script[i - 1].t_us > e->t_us) {
+        script[i] = script[i - 1];
+        i--;
+    }
+    script[i] = *e;
+    return true;
+}
+
+// Uma mudança de nível do botão, com repique: a borda, a volta e a borda de novo
+static bool script_add_button(char kind, uint64_t t_us, bool pressed) {
+    for (int k = 0; k < 3; k++) {
+        script_event_t e = {.t_us = t_us + (uint64_t)k * SIM_BOUNCE_US, .kind = kind};
+        e.pressed = (k == 1) ? !pressed : pressed;
+        e.input = pressed && k == 0;
+        if (!script_add(&e)) return false;
+    }
+    return true;
+}
+
+static bool load_script(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "não foi possível abrir o roteiro %s\n", path);
+        return false;
+    }
+    char line[256];
+    unsigned int number = 0;
+    uint64_t last_us = 0;
+    while (fgets(line, sizeof(line), f)) {
+        number++;
+        char *comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+        double ms;
+        char word[16];
+        int used = 0;
+        if (sscanf(line, " %lf %15s %n", &ms, word, &used) < 2) continue;  // Linha vazia
+
+        script_event_t e = {.t_us = (uint64_t)llround(ms * 1000)};
+        char *rest = line + used;
+        rest[strcspn(rest, "\r\n")] = '\0';
+        if (e.t_us < last_us) {
+            fprintf(stderr, "%s:%u: eventos fora de ordem\n", path, number);
+            fclose(f);
+            return false;
+        }
+        last_us = e.t_us;
+
+        bool added;
+        if (strcmp(word, "A") == 0 || strcmp(word, "B") == 0 || strcmp(word, "J") == 0) {
+            // Sem complemento, um toque: aperta e solta SIM_CLICK_MS depois
+            if (strncmp(rest, "down", 4) == 0) {
+                added = script_add_button(word[0], e.t_us, true);
+            } else if (strncmp(rest, "up", 2) == 0) {
+                added = script_add_button(word[0], e.t_us, false);
+            } else {
+                added = script_add_button(word[0], e.t_us, true) &&
+                        script_add_button(word[0], e.t_us + (uint64_t)SIM_CLICK_MS * 1000, false);
+            }
+        } else if (strcmp(word, "key") == 0 && rest[0] != '\0') {
+            e.kind = 'k';
+            e.text[0] = rest[0];
+            added = script_add(&e);
+        } else if (strcmp(word, "line") == 0) {
+            e.kind = 'k';  // Linha inteira do console, terminada por Enter
+            snprintf(e.text, sizeof(e.text), "%s\n", rest);
+            added = script_add(&e);
+        } else if (strcmp(word, "mark") == 0) {
+            e.kind = 'm';
+            snprintf(e.text, sizeof(e.text), "%s", rest);
+            added = script_add(&e);
+        } else if (strcmp(word, "end") == 0) {
+            e.kind = 'e';
+            added = script_add(&e);
+        } else {
+            fprintf(stderr, "%s:%u: evento desconhecido '%s'\n", path, number, word);
+            fclose(f);
+            return false;
+        }
+        if (!added) {
+            fprintf(stderr, "%s:%u: eventos demais (máximo %d)\n", path, number, SCRIPT_MAX_EVENTS);
+            break;
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+bool hal_sim_configure(const hal_sim_config_t *config) {
+    sim_config = *config;
+    uint64_t last_us = 0;
+
+    cookie_io_functions_t serial_io = {.write = serial_write};
+    FILE *serial = fopencookie(NULL, "w", serial_io);
+    if (serial) {
+        serial_out = stdout;
+        stdout = serial;
+    }
+
+    if (config->wav) {
+        wav_adc = wav_read_adc(config->wav, &wav_rate, &wav_count);
+        if (!wav_adc) {
+            fprintf(stderr, "não foi possível ler %s\n", config->wav);
+            return false;
+        }
+        last_us = (uint64_t)wav_count * 1000000 / wav_rate;
+    }
+    if (config->script) {
+        if (!load_script(config->script)) return false;
+        if (script_count > 0) {
+            const script_event_t *last = &script[script_count - 1];
+            uint64_t t = last->t_us + ((last->kind == 'e') ? 0 : (uint64_t)SIM_TAIL_MS * 1000);
+            if (t > last_us) last_us = t;
+        }
+    }
+    if (config->duration_ms > 0) end_us = (uint64_t)config->duration_ms * 1000;
+    else if (last_us > 0) end_us = last_us;
+
+    if (config->out_dir) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/events.csv", config->out_dir);
+        events = fopen(path, "w");
+        if (!events) {
+            fprintf(stderr, "não foi possível criar %s\n", path);
+            return false;
+        }
+        fprintf(events, "t_us,event,value,done_us,data\n");
+    }
+    clock_gettime(CLOCK_MONOTONIC, &wall_mark);
+    return true;
+}
+
+static void report_latency(FILE *f, const char *name, const latency_t *l) {
+    if (l->count == 0) {
+        fprintf(f, "entrada -> %s: sem quadros após as %u entradas\n", name, (unsigned)inputs_total);
+        return;
+    }
+    fprintf(f, "entrada -> %s: %u respondidas, min %.2f ms, média %.2f ms, max %.2f ms",
+            name, l->count, l->min_us / 1e3, (double)l->sum_us / l->count / 1e3, l->max_us / 1e3);
+    if (l->pending + l->lost > 0) fprintf(f, ", %u sem resposta", l->pending + l->lost);
+    fputc('\n', f);
+}
+
+static void report_output(FILE *f, const char *name, const output_stats_t *s) {
+    double seconds = now_us / 1e6;
+    fprintf(f, "%s: %u quadros (%.1f/s), barramento ocupado %.1f%%", name, (unsigned)s->frames,
+            seconds > 0 ? s->frames / seconds : 0.0, now_us ? 100.0 * s->busy_us / now_us : 0.0);
+    if (s->frames > 0) {
+        fprintf(f, ", bytes por quadro: média %.1f, max %llu, total %llu", (double)s->bytes / s->frames,
+                (unsigned long long)s->max_bytes, (unsigned long long)s->bytes);
+    }
+    fputc('\n', f);
+}
+
+static void write_report(FILE *f) {
+    fprintf(f, "tempo simulado: %.3f s, blocos do ADC: %llu (%u perdidos)\n", now_us / 1e6,
+            (unsigned long long)(mic_fed / CAPTURE_BLOCK_SIZE), mic_capture ? (unsigned)mic_capture->overruns : 0);
+    report_output(f, "oled", &oled_stats);
+    report_output(f, "matriz", &leds_stats);
+    fprintf(f, "serial: %llu bytes no modo binário, %u quadros da gravação, %llu bytes fora de quadro\n",
+            (unsigned long long)serial_binary_bytes, (unsigned)serial_frames, (unsigned long long)serial_stray);
+    fprintf(f, "entradas: %u\n", (unsigned)inputs_total);
+    report_latency(f, "oled", &oled_latency);
+    report_latency(f, "matriz", &leds_latency);
+}
+
+// Fim da simulação: o laço do firmware nunca retorna, então o processo termina aqui.
+// Sai com 1 se a gravação pela serial teve bytes fora de quadro.
+static void sim_finish(void) {
+    fflush(stdout);
+    if (serial_out) fflush(serial_out);
+    if (console_binary) serial_decode(true);
+    write_report(stderr);
+    if (sim_config.out_dir) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/report.txt", sim_config.out_dir);
+        FILE *f = fopen(path, "w");
+        if (f) {
+            write_report(f);
+            fclose(f);
+        }
+    }
+    if (events) fclose(events);
+    exit(serial_stray > 0 ? 1 : 0);
+}
@@ -0,0 +1,42 @@
+#ifndef HAL_HOST_H
+#define HAL_HOST_H
+
+#include <stdbool.h>
+
+// Configuração do simulador (backend de host da HAL, ver inc/hal.h).
+//
+// Entradas:
+//   wav       microfone: WAV PCM 16 bits mono, reamostrado para a taxa do ADC;
+//             depois do fim, silêncio (NULL = só silêncio)
+//   script    roteiro de eventos, uma linha por evento (# inicia comentário):
+//               <ms> A | B | J      toque no botão A, B ou do joystick (solta após 80 ms)
+//               <ms> A down | up    aperta ou solta o botão (idem B e J), para toques longos
+//               <ms> key <c>        caractere no console serial
+//               <ms> mark <texto>   marcador copiado para events.csv
+//               <ms> end            encerra a simulação
+// Saídas em out_dir (que já deve existir):
+//   events.csv      t_us,event,value,done_us,data: entradas, quadros do OLED (bytes
+//                   no barramento, fim do envio, imagem), quadros da matriz (bytes,
+//                   fim, cores GRB), mudanças do LED RGB e do buzzer
+//   oled_NNNNN.pbm  imagem da tela após cada envio ao OLED (pixel aceso = preto)
+//   report.txt      latência entrada -> OLED/matriz e bytes por quadro (também em stderr)
+//
+// Cada mudança de nível de um botão chega com repique: três bordas a 0,3 ms uma da
+// outra. O tempo é virtual: o laço roda sem custo e, quando dorme, o relógio salta para
+// o próximo evento (bloco do ADC, entrada do roteiro, alarme ou timeout). Com cpu_scale > 0,
+// o tempo real gasto entre chamadas à HAL, vezes cpu_scale, também avança o relógio
+// (ex.: 20 para um host ~20x mais rápido que o RP2040); o resultado deixa de ser
+// determinístico. A simulação termina no fim do WAV ou 500 ms após o último evento
+// do roteiro (o que vier por último), em `end` ou após duration_ms, se dado.
+typedef struct {
+    const char *wav;
+    const char *script;
+    const char *out_dir;
+    double cpu_scale;
+    unsigned int duration_ms;
+} hal_sim_config_t;
+
+// Carrega as entradas; false (com a mensagem em stderr) se algum arquivo falhar
+bool hal_sim_configure(const hal_sim_config_t *config);
+
+#endif // HAL_HOST_H
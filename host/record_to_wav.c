@@ -0,0 +1,114 @@
+// Decodifica o fluxo do modo Gravar (quadros "AFRC", ver inc/record.h) em um WAV.
+//
+// Uso:
+//   cat /dev/ttyACM0 > gravacao.bin      (enquanto o modo Gravar estiver ativo)
+//   ./build-host/record_to_wav gravacao.bin gravacao.wav
+//
+// A entrada "-" lê da entrada padrão. Bytes fora de um quadro válido (texto da serial,
+// quadros corrompidos) são descartados até a próxima marca. Blocos perdidos,
+// detectados pela sequência, viram silêncio (2048) para manter a base de tempo.
+// O resumo vai para stderr; a saída é 1 se nenhum quadro foi encontrado.
+
+#include "record.h"
+#include "wav.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define READ_CHUNK 65536
+#define MAX_GAP_BLOCKS 4096   // Lacunas maiores são tratadas como uma nova gravação
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        fprintf(stderr, "uso: %s entrada.bin|- saida.wav\n", argv[0]);
+        return 1;
+    }
+    FILE *in = (strcmp(argv[1], "-") == 0) ? stdin : fopen(argv[1], "rb");
+    if (!in) {
+        fprintf(stderr, "não foi possível abrir %s\n", argv[1]);
+        return 1;
+    }
+
+    static uint8_t buffer[2 * READ_CHUNK + RECORD_MAX_FRAME];
+    static uint16_t samples[RECORD_MAX_SAMPLES];
+    static uint16_t silence[RECORD_MAX_SAMPLES];
+    for (uint32_t i = 0; i < RECORD_MAX_SAMPLES; i++) silence[i] = 2048;
+
+    wav_writer_t wav = {0};
+    bool open = false;
+    size_t len = 0;
+    uint32_t frames = 0, lost = 0, skipped = 0, next_seq = 0;
+    bool eof = false;
+
+    while (!eof || len > 0) {
+        if (!eof && len < READ_CHUNK) {
+            size_t n = fread(buffer + len, 1, READ_CHUNK, in);
+            if (n == 0) eof = true;
+            len += n;
+        }
+
+        // Consome todos os quadros completos do buffer
+        size_t pos = 0;
+        while (pos < len) {
+            record_header_t header;
+            int size = record_unpack(buffer + pos, len - pos, &header, samples);
+            if (size < 0) {
+                pos++;        // Não é um quadro: procura a próxima marca
+                skipped++;
+                continue;
+            }
+            if (size == 0) {
+                if (eof) {
+                    skipped += (uint32_t)(len - pos);  // Quadro truncado no fim do arquivo
+                    pos = len;
+                }
+                break;
+            }
+            pos += (size_t)size;
+
+            if (!open) {
+                if (!wav_open(&wav, argv[2], header.sample_rate)) {
+                    fprintf(stderr, "não foi possível criar %s\n", argv[2]);
+                    return 1;
+                }
+                open = true;
+                next_seq = header.seq;
+            } else if (header.sample_rate != wav.sample_rate) {
+                fprintf(stderr, "taxa mudou de %u para %u Hz: gravação encerrada no quadro %u\n",
+                        (unsigned)wav.sample_rate, (unsigned)header.sample_rate, (unsigned)frames);
+                eof = true;
+                len = 0;
+                pos = 0;
+                break;
+            }
+
+            uint32_t gap = header.seq - next_seq;
+            if (gap > 0 && gap <= MAX_GAP_BLOCKS) {
+                for (uint32_t k = 0; k < gap; k++) wav_write_adc(&wav, silence, header.count);
+                lost += gap;
+            }
+            wav_write_adc(&wav, samples, header.count);
+            next_seq = header.seq + 1;
+            frames++;
+        }
+
+        memmove(buffer, buffer + pos, len - pos);
+        len -= pos;
+        if (eof && pos == 0) break;
+    }
+    if (in != stdin) fclose(in);
+
+    if (!open) {
+        fprintf(stderr, "nenhum quadro encontrado (%u bytes descartados)\n", (unsigned)skipped);
+        return 1;
+    }
+    uint32_t total = wav.samples, rate = wav.sample_rate;
+    if (!wav_close(&wav)) {
+        fprintf(stderr, "erro ao escrever %s\n", argv[2]);
+        return 1;
+    }
+    fprintf(stderr, "%u quadros, %u amostras a %u Hz (%.2f s), %u blocos perdidos, %u bytes descartados\n",
+            (unsigned)frames, (unsigned)total, (unsigned)rate, (double)total / rate, (unsigned)lost,
+            (unsigned)skipped);
+    return 0;
+}
@@ -0,0 +1,43 @@
+// Simulador do firmware no Linux: o main.c do firmware, compilado para o host, roda
+// sobre o backend de simulação da HAL (hal_host.c, formatos em hal_host.h).
+//
+// Uso:
+//   ./build-host/afinador_sim --wav gravacao.wav --script roteiro.txt --out saida/
+//
+// Opções: --wav arquivo (microfone), --script arquivo (botões e console),
+//         --out diretório (events.csv, quadros do OLED em PBM e report.txt),
+//         --cpu-scale F (cobra o tempo real do laço x F), --duration-ms N
+// A saída padrão é a mesma da serial do firmware (uma linha por quadro analisado). No
+// modo Gravar ela é conferida como no record_to_wav; bytes fora de quadro dão saída 1.
+
+#include "hal_host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int afinador_main(void);  // main() do firmware, renomeado na compilação
+
+int main(int argc, char **argv) {
+    hal_sim_config_t config = {0};
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--wav") == 0 && i + 1 < argc) {
+            config.wav = argv[++i];
+        } else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc) {
+            config.script = argv[++i];
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            config.out_dir = argv[++i];
+        } else if (strcmp(argv[i], "--cpu-scale") == 0 && i + 1 < argc) {
+            config.cpu_scale = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--duration-ms") == 0 && i + 1 < argc) {
+            config.duration_ms = (unsigned int)atoi(argv[++i]);
+        } else {
+            fprintf(stderr,
+                    "uso: %s [--wav arquivo.wav] [--script roteiro.txt] [--out dir] [--cpu-scale F] "
+                    "[--duration-ms N]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (!hal_sim_configure(&config)) return 1;
+    return afinador_main();  // Termina pelo simulador, no fim das entradas
+}
@@ -0,0 +1,116 @@
+#include "wav.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define WAV_HEADER_SIZE 44
+
+static void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+// Cabeçalho RIFF/WAVE com um único bloco "data" de `samples` amostras
+static void wav_header(uint8_t *h, uint32_t sample_rate, uint32_t samples) {
+    uint32_t data_size = samples * 2;
+    memcpy(h, "RIFF", 4);
+    put_u32(h + 4, 36 + data_size);
+    memcpy(h + 8, "WAVEfmt ", 8);
+    put_u32(h + 16, 16);               // Tamanho do bloco fmt
+    put_u16(h + 20, 1);                // PCM
+    put_u16(h + 22, 1);                // Mono
+    put_u32(h + 24, sample_rate);
+    put_u32(h + 28, sample_rate * 2);  // Bytes por segundo
+    put_u16(h + 32, 2);                // Bytes por quadro
+    put_u16(h + 34, 16);               // Bits por amostra
+    memcpy(h + 36, "data", 4);
+    put_u32(h + 40, data_size);
+}
+
+bool wav_open(wav_writer_t *w, const char *path, uint32_t sample_rate) {
+    w->file = fopen(path, "wb");
+    w->sample_rate = sample_rate;
+    w->samples = 0;
+    if (!w->file) return false;
+
+    uint8_t h[WAV_HEADER_SIZE];
+    wav_header(h, sample_rate, 0);
+    return fwrite(h, 1, sizeof(h), w->file) == sizeof(h);
+}
+
+bool wav_write_adc(wav_writer_t *w, const uint16_t *adc, uint32_t count) {
+    uint8_t out[512];
+    while (count > 0) {
+        uint32_t n = (count > sizeof(out) / 2) ? (uint32_t)(sizeof(out) / 2) : count;
+        for (uint32_t i = 0; i < n; i++) {
+            put_u16(out + 2 * i, (uint16_t)(int16_t)(((int32_t)(adc[i] & 0x0FFF) - 2048) * 16));
+        }
+        if (fwrite(out, 2, n, w->file) != n) return false;
+        w->samples += n;
+        adc += n;
+        count -= n;
+    }
+    return true;
+}
+
+bool wav_close(wav_writer_t *w) {
+    uint8_t h[WAV_HEADER_SIZE];
+    wav_header(h, w->sample_rate, w->samples);
+    bool ok = fseek(w->file, 0, SEEK_SET) == 0 && fwrite(h, 1, sizeof(h), w->file) == sizeof(h);
+    ok &= fclose(w->file) == 0;
+    w->file = NULL;
+    return ok;
+}
+
+uint16_t *wav_read_adc(const char *path, uint32_t *sample_rate, uint32_t *count) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+
+    uint8_t riff[12];
+    if (fread(riff, 1, 12, f) != 12 || memcmp(riff, "RIFF", 4) != 0 || memcmp(riff + 8, "WAVE", 4) != 0) {
+        fclose(f);
+        return NULL;
+    }
+
+    // Percorre os blocos até "data", conferindo o formato em "fmt "
+    bool format_ok = false;
+    uint8_t chunk[8];
+    while (fread(chunk, 1, 8, f) == 8) {
+        uint32_t size = get_u32(chunk + 4);
+        if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+            uint8_t fmt[16];
+            if (fread(fmt, 1, 16, f) != 16) break;
+            format_ok = get_u16(fmt) == 1 && get_u16(fmt + 2) == 1 && get_u16(fmt + 14) == 16;
+            *sample_rate = get_u32(fmt + 4);
+            if (fseek(f, (long)(size - 16 + (size & 1)), SEEK_CUR) != 0) break;
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (!format_ok) break;
+            uint32_t n = size / 2;
+            uint16_t *adc = malloc((n > 0 ? n : 1) * sizeof(uint16_t));
+            uint8_t pair[2];
+            uint32_t i = 0;
+            while (adc && i < n && fread(pair, 1, 2, f) == 2) {
+                adc[i++] = (uint16_t)(((int16_t)get_u16(pair) >> 4) + 2048);
+            }
+            fclose(f);
+            *count = i;
+            return adc;
+        } else if (fseek(f, (long)(size + (size & 1)), SEEK_CUR) != 0) {
+            break;
+        }
+    }
+    fclose(f);
+    return NULL;
+}
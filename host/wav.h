@@ -0,0 +1,28 @@
+#ifndef WAV_H
+#define WAV_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// WAV PCM de 16 bits, mono, para as gravações do ADC no host.
+//
+// Uma amostra do ADC (12 bits, centrada em 2048) vira (adc - 2048) x 16 no WAV; a
+// leitura faz o caminho inverso, então gravar e reler devolve as mesmas amostras.
+// Qualquer WAV PCM de 16 bits mono pode ser lido (os 12 bits mais altos viram o ADC).
+
+typedef struct {
+    FILE *file;
+    uint32_t sample_rate;
+    uint32_t samples;       // Amostras já escritas
+} wav_writer_t;
+
+// Cria o arquivo com o cabeçalho (tamanhos corrigidos em wav_close)
+bool wav_open(wav_writer_t *w, const char *path, uint32_t sample_rate);
+bool wav_write_adc(wav_writer_t *w, const uint16_t *adc, uint32_t count);
+bool wav_close(wav_writer_t *w);
+
+// Lê o arquivo inteiro como amostras do ADC (malloc; liberar com free). NULL em erro.
+uint16_t *wav_read_adc(const char *path, uint32_t *sample_rate, uint32_t *count);
+
+#endif // WAV_H
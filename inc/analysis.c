@@ -0,0 +1,190 @@
+#include "analysis.h"
+#include "tuner.h"
+#include "telemetry.h"
+
+static int16_t centered[ANALYSIS_MAX_BLOCK];  // Bloco sem DC entregue ao detector
+
+void analysis_init(analysis_t *an, uint32_t sample_rate, uint16_t volume_threshold) {
+    an->sample_rate = sample_rate;
+    level_init(&an->level, sample_rate, volume_threshold);
+    tracker_init(&an->tracker, sample_rate);
+    an->frequency = 0;
+    an->window = 0;
+    strobe_init(&an->strobe, sample_rate);
+    an->strobe_midi = 0;
+    strum_init(&an->strum, sample_rate);
+    an->stages = ANALYSIS_ALL;
+}
+
+void analysis_set_stages(analysis_t *an, uint8_t stages) {
+    uint8_t started = stages & ~an->stages;
+    if (started & ANALYSIS_STROBE) {
+        an->strobe_midi = 0;
+        strobe_set_target(&an->strobe, 0);
+    }
+    if (started & ANALYSIS_STRUM) {
+        // Refaz o banco com as mesmas cordas, zerando os ressonadores
+        uint8_t midi[STRUM_STRINGS];
+        for (uint8_t i = 0; i < an->strum.reading.count; i++) midi[i] = an->strum.reading.strings[i].midi;
+        strum_set_strings(&an->strum, midi, an->strum.reading.count);
+    }
+    an->stages = stages;
+}
+
+void analysis_set_profile(analysis_t *an, const tuning_profile_t *profile, uint32_t block_size) {
+    tuner_set_profile(profile);
+    an->window = profile_window(profile, an->sample_rate, block_size);
+    tuner_init(an->window);  // Plano da FFT do produto harmônico para a nova janela
+
+    if (profile->strings > 0) {
+        strum_set_strings(&an->strum, profile->midi, profile->strings);
+    } else {
+        strum_set_strings(&an->strum, strum_standard_tuning, STRUM_STRINGS);
+    }
+    tracker_reset(&an->tracker);
+    an->frequency = 0;
+    an->strobe_midi = 0;
+    strobe_set_target(&an->strobe, 0);
+}
+
+// O estrobo acompanha todas as amostras do bloco, travado na nota mais próxima da
+// frequência acompanhada; trocar de nota reinicia o acompanhamento da fase
+static void analysis_strobe(analysis_t *an, const uint16_t *block, uint32_t size, analysis_result_t *out) {
+    out->strobe.valid = false;
+    if (an->stages & ANALYSIS_STROBE) {
+        if (out->in_range && out->note.midi != an->strobe_midi) {
+            strobe_set_target(&an->strobe, out->note.target_freq);
+            an->strobe_midi = out->note.midi;
+        }
+        strobe_process(&an->strobe, block, size);
+        strobe_read(&an->strobe, &out->strobe);
+        out->strobe.valid = out->strobe.valid && out->active && out->in_range;
+    }
+
+    // O banco das cordas não depende da nota detectada
+    out->strum.count = 0;
+    if (an->stages & ANALYSIS_STRUM) {
+        strum_process(&an->strum, block, size);
+        strum_read(&an->strum, &out->strum);
+    }
+}
+
+// Nível do bloco numa única passada, que também entrega as amostras sem DC em centered
+static void analysis_level(analysis_t *an, const uint16_t *block, uint32_t size, analysis_result_t *out) {
+    level_reading_t reading;
+    TELEMETRY_BEGIN(AMPLITUDE);
+    out->active = level_process(&an->level, block, size, centered, &reading);
+    TELEMETRY_END(AMPLITUDE);
+    out->amplitude = reading.rms;
+    out->peak = reading.peak;
+    out->noise_floor = reading.floor;
+}
+
+// Acompanha a estimativa do bloco (0 = nenhuma) e busca a nota da frequência
+// acompanhada. Blocos sem estimativa também contam para soltar a nota.
+static void analysis_track(analysis_t *an, fixed_t new_freq, uint32_t samples, analysis_result_t *out) {
+    TELEMETRY_BEGIN(SMOOTHING);
+    an->frequency = tracker_update(&an->tracker, new_freq, out->clarity, samples);
+    TELEMETRY_END(SMOOTHING);
+    out->frequency = an->frequency;
+    out->in_range = false;
+    if (out->active && an->frequency > 0) {
+        TELEMETRY_BEGIN(NOTE);
+        out->in_range = get_closest_note(an->frequency, &out->note);
+        TELEMETRY_END(NOTE);
+    }
+}
+
+// Caminho completo do modo afinador para um bloco (sem E/S). Blocos com a porta de
+// ruído fechada não passam pelo detector.
+void analysis_process(analysis_t *an, const uint16_t *block, uint32_t size, uint32_t block_seq,
+                      analysis_result_t *out) {
+    if (size > ANALYSIS_MAX_BLOCK) size = ANALYSIS_MAX_BLOCK;
+    out->block_seq = block_seq;
+    analysis_level(an, block, size, out);
+    out->clarity = 0;
+
+    fixed_t new_freq = 0;
+    if (out->active) {
+        // O detector usa só a janela do perfil, no fim do bloco (amostras mais recentes)
+        uint32_t window = (an->window > 0 && an->window < size) ? an->window : size;
+        TELEMETRY_BEGIN(PITCH);
+        new_freq = calculate_frequency(centered + size - window, window, an->sample_rate);
+        TELEMETRY_END(PITCH);
+        out->clarity = detected_clarity;
+    }
+    analysis_track(an, new_freq, size, out);
+    TELEMETRY_BEGIN(STROBE);
+    analysis_strobe(an, block, size, out);
+    TELEMETRY_END(STROBE);
+}
+
+// A porta de ruído vale para o bloco recebido; a frequência vem da janela inteira.
+// Com a porta fechada a janela continua deslizando, mas não há estimativa.
+// Sem o produto harmônico: a confirmação de oitava exige o bloco completo da FFT.
+bool analysis_process_stream(analysis_t *an, pitch_stream_t *ps, const uint16_t *block, uint32_t size,
+                             uint32_t block_seq, analysis_result_t *out) {
+    if (size > ANALYSIS_MAX_BLOCK) size = ANALYSIS_MAX_BLOCK;
+    analysis_level(an, block, size, out);
+
+    pitch_result_t pitch;
+    TELEMETRY_BEGIN(PITCH);
+    bool hop = pitch_stream_push(ps, centered, size, out->active, &pitch);
+    TELEMETRY_END(PITCH);
+    if (!hop) {
+        // A fase do estrobo e a dos ressonadores não podem perder amostras
+        TELEMETRY_BEGIN(STROBE);
+        if (an->stages & ANALYSIS_STROBE) strobe_process(&an->strobe, block, size);
+        if (an->stages & ANALYSIS_STRUM) strum_process(&an->strum, block, size);
+        TELEMETRY_END(STROBE);
+        return false;
+    }
+
+    out->block_seq = block_seq;
+    out->clarity = pitch.clarity;
+
+    // Sem período claro não há estimativa (como em analysis_process)
+    fixed_t new_freq = (out->active && pitch.clarity >= PITCH_MIN_CLARITY) ? pitch.frequency * CALIBRATION_FACTOR : 0;
+    analysis_track(an, new_freq, ps->hop, out);
+    TELEMETRY_BEGIN(STROBE);
+    analysis_strobe(an, block, size, out);
+    TELEMETRY_END(STROBE);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Canal entre núcleos
+//
+// As barreiras garantem que o consumidor veja o número de sequência e os dados na
+// ordem em que foram escritos (DMB no Cortex-M0+).
+
+void analysis_channel_init(analysis_channel_t *ch) {
+    ch->seq = 0;
+}
+
+void analysis_publish(analysis_channel_t *ch, const analysis_result_t *result) {
+    uint32_t seq = ch->seq;
+    ch->seq = seq + 1;  // Ímpar: escrita em andamento
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    ch->slot = *result;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    ch->seq = seq + 2;
+}
+
+// Copia o resultado mais recente se houver um novo desde *last_seq.
+// Retorna false se nada foi publicado desde a última leitura.
+bool analysis_latest(analysis_channel_t *ch, uint32_t *last_seq, analysis_result_t *out) {
+    uint32_t before, after = 0;
+    do {
+        before = ch->seq;
+        if (before == *last_seq) return false;
+        if (before & 1) continue;  // Produtor no meio da escrita
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        *out = ch->slot;
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        after = ch->seq;
+    } while ((before & 1) || before != after);
+
+    *last_seq = before;
+    return true;
+}
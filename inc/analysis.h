@@ -0,0 +1,83 @@
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "note_map.h"
+#include "pitch.h"
+#include "strobe.h"
+#include "strum.h"
+#include "profiles.h"
+#include "level.h"
+#include "tracker.h"
+
+// Análise de um bloco capturado (nível, frequência, acompanhamento e nota) e o canal
+// que entrega o resultado mais recente de um núcleo a outro.
+
+#define ANALYSIS_MAX_BLOCK PITCH_MAX_WINDOW  // Maior bloco aceito por analysis_process()
+
+// Etapas opcionais, rodadas só no modo que as mostra (o detector e o nível rodam sempre)
+#define ANALYSIS_STROBE (1u << 0)   // Estrobo travado na nota
+#define ANALYSIS_STRUM (1u << 1)    // Banco de Goertzel das cordas
+#define ANALYSIS_ALL (ANALYSIS_STROBE | ANALYSIS_STRUM)
+
+// Parâmetros e estado da análise (o acompanhamento depende dos blocos anteriores)
+typedef struct {
+    uint32_t sample_rate;       // Taxa de amostragem dos blocos (Hz)
+    level_t level;              // DC, RMS, piso de ruído e porta que libera o detector
+    tracker_t tracker;          // Mediana e filtro de Kalman das estimativas, em cents
+    fixed_t frequency;          // Frequência acompanhada (Hz, Q16.16; 0 = nenhuma nota)
+    uint32_t window;            // Amostras mais recentes do bloco usadas pelo detector (0 = todas)
+    strobe_t strobe;            // Estrobo travado na nota mais próxima
+    uint8_t strobe_midi;        // Nota em que o estrobo está travado (0 = nenhuma)
+    strum_t strum;              // Banco de Goertzel das cordas soltas
+    uint8_t stages;             // Etapas opcionais ativas (ANALYSIS_STROBE, ANALYSIS_STRUM)
+} analysis_t;
+
+// Resultado de um bloco
+typedef struct {
+    uint32_t block_seq;     // Número do bloco analisado
+    uint16_t amplitude;     // RMS do bloco sem DC (contagens do ADC)
+    uint16_t peak;          // Maior |amostra - DC| do bloco
+    uint16_t noise_floor;   // Piso de ruído estimado (RMS)
+    bool active;            // Porta de ruído aberta: só então o detector roda
+    bool in_range;          // Nota dentro da faixa B0..C7
+    fixed_t frequency;      // Frequência acompanhada (Hz, Q16.16; 0 = nenhuma nota)
+    q15_t clarity;          // Confiança do detector (Q15, 0 a 1)
+    note_info_t note;       // Nota mais próxima e desvio em cents
+    strobe_reading_t strobe; // Desvio fino e ângulo do estrobo (inválido sem ANALYSIS_STROBE)
+    strum_reading_t strum;  // Desvio de cada corda solta (nenhuma sem ANALYSIS_STRUM)
+} analysis_result_t;
+
+// Canal de valor mais recente (seqlock) para um produtor e um consumidor.
+// O produtor nunca espera: cada publicação substitui a anterior, e o consumidor
+// recebe apenas o último resultado, descartando os que não chegou a ler.
+typedef struct {
+    volatile uint32_t seq;      // Ímpar enquanto o produtor escreve
+    analysis_result_t slot;
+} analysis_channel_t;
+
+// volume_threshold: RMS mínimo para abrir a porta de ruído, qualquer que seja o piso.
+// Começa com todas as etapas ativas.
+void analysis_init(analysis_t *an, uint32_t sample_rate, uint16_t volume_threshold);
+
+// Escolhe as etapas opcionais. Uma etapa religada recomeça do zero (a fase do estrobo e
+// a dos ressonadores não valem depois de blocos pulados). Deve rodar no núcleo da análise.
+void analysis_set_stages(analysis_t *an, uint8_t stages);
+
+// Troca o perfil: faixa e alvos do detector, janela (até block_size) e cordas do
+// modo Cordas. Solta a nota acompanhada e reinicia o estrobo. Deve rodar no núcleo da análise.
+void analysis_set_profile(analysis_t *an, const tuning_profile_t *profile, uint32_t block_size);
+void analysis_process(analysis_t *an, const uint16_t *block, uint32_t size, uint32_t block_seq,
+                      analysis_result_t *out);
+
+// Variante contínua: cada bloco (tipicamente um salto) alimenta a janela deslizante.
+// Retorna false se o bloco não completou um salto com a janela cheia.
+bool analysis_process_stream(analysis_t *an, pitch_stream_t *ps, const uint16_t *block, uint32_t size,
+                             uint32_t block_seq, analysis_result_t *out);
+
+void analysis_channel_init(analysis_channel_t *ch);
+void analysis_publish(analysis_channel_t *ch, const analysis_result_t *result);
+bool analysis_latest(analysis_channel_t *ch, uint32_t *last_seq, analysis_result_t *out);
+
+#endif // ANALYSIS_H
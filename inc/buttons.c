@@ -0,0 +1,124 @@
+#include "buttons.h"
+
+#define DEBOUNCE_US ((uint32_t)BUTTON_DEBOUNCE_MS * 1000)
+#define LONG_US ((uint32_t)BUTTON_LONG_MS * 1000)
+#define REPEAT_US ((uint32_t)BUTTON_REPEAT_MS * 1000)
+#define TICK_US ((uint32_t)BUTTON_TICK_MS * 1000)
+
+static void queue_init(button_queue_t *q) {
+    q->head = 0;
+    q->tail = 0;
+    q->dropped = 0;
+}
+
+static bool queue_push(button_queue_t *q, uint8_t button, uint8_t action, uint32_t t_us) {
+    uint32_t head = q->head;
+    if (head - q->tail >= BUTTON_QUEUE) {
+        q->dropped++;
+        return false;
+    }
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    button_event_t *slot = &q->slots[head & (BUTTON_QUEUE - 1)];
+    slot->t_us = t_us;
+    slot->button = button;
+    slot->action = action;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    q->head = head + 1;
+    return true;
+}
+
+static bool queue_pop(button_queue_t *q, button_event_t *event) {
+    uint32_t tail = q->tail;
+    if (q->head == tail) return false;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    *event = q->slots[tail & (BUTTON_QUEUE - 1)];
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    q->tail = tail + 1;
+    return true;
+}
+
+// Quanto falta até `deadline` (0 se já passou); instantes de 32 bits comparados pela diferença
+static uint32_t time_left(uint32_t deadline, uint32_t now_us) {
+    int32_t left = (int32_t)(deadline - now_us);
+    return (left > 0) ? (uint32_t)left : 0;
+}
+
+void buttons_init(buttons_t *bt, uint8_t count) {
+    bt->count = (count > BUTTONS_MAX) ? BUTTONS_MAX : count;
+    bt->idle = true;
+    queue_init(&bt->edges);
+    queue_init(&bt->events);
+    for (uint8_t i = 0; i < BUTTONS_MAX; i++) {
+        button_state_t *st = &bt->state[i];
+        st->level = false;
+        st->settling = false;
+        st->pressed = false;
+        st->held = false;
+        st->edge_us = 0;
+        st->hold_us = 0;
+    }
+}
+
+bool buttons_edge(buttons_t *bt, uint8_t button, bool pressed, uint32_t t_us) {
+    if (button >= bt->count) return false;
+    // Com a fila cheia a borda se perde, mas o alarme ainda roda: a próxima traz o nível atual
+    queue_push(&bt->edges, button, pressed ? BUTTON_PRESS : BUTTON_RELEASE, t_us);
+    if (!bt->idle) return false;
+    bt->idle = false;
+    return true;
+}
+
+void buttons_alarm_failed(buttons_t *bt) {
+    bt->idle = true;
+}
+
+uint32_t buttons_update(buttons_t *bt, uint32_t now_us) {
+    button_event_t edge;
+    while (queue_pop(&bt->edges, &edge)) {
+        button_state_t *st = &bt->state[edge.button];
+        st->level = edge.action == BUTTON_PRESS;
+        st->edge_us = edge.t_us;
+        st->settling = true;
+    }
+
+    uint32_t next = UINT32_MAX;  // Nada a esperar
+    for (uint8_t i = 0; i < bt->count; i++) {
+        button_state_t *st = &bt->state[i];
+        if (st->settling) {
+            uint32_t left = time_left(st->edge_us + DEBOUNCE_US, now_us);
+            if (left > 0) {
+                if (left < next) next = left;
+                continue;  // Ainda repicando: segura também o toque longo
+            }
+            st->settling = false;
+            if (st->level != st->pressed) {
+                st->pressed = st->level;
+                queue_push(&bt->events, i, st->pressed ? BUTTON_PRESS : BUTTON_RELEASE, now_us);
+                if (st->pressed) {
+                    st->held = false;
+                    st->hold_us = now_us + LONG_US;
+                }
+            }
+        }
+        if (!st->pressed) continue;
+
+        if (time_left(st->hold_us, now_us) == 0) {
+            queue_push(&bt->events, i, st->held ? BUTTON_REPEAT : BUTTON_LONG, now_us);
+            st->held = true;
+            st->hold_us = now_us + REPEAT_US;  // Um alarme atrasado não dispara uma rajada
+        }
+        uint32_t left = time_left(st->hold_us, now_us);
+        if (left < next) next = left;
+    }
+
+    if (next == UINT32_MAX) {
+        bt->idle = true;
+        return 0;
+    }
+    if (next > TICK_US) next = TICK_US;  // Com um botão seguro, a soltura só chega no próximo tique
+    return (next > 0) ? next : 1;
+}
+
+bool buttons_next(buttons_t *bt, button_event_t *event) {
+    return queue_pop(&bt->events, event);
+}
@@ -0,0 +1,85 @@
+#ifndef BUTTONS_H
+#define BUTTONS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Entrada dos botões em três estágios, sem trava entre eles:
+//   interrupção do GPIO -> fila de bordas -> debouncer (alarme) -> fila de eventos -> laço
+//
+// A interrupção só registra a borda (botão, nível lido no pino e instante) e, se o
+// debouncer estava parado, arma o alarme. O debouncer aceita um nível depois de
+// BUTTON_DEBOUNCE_MS sem bordas, então o repique do aperto e o da soltura somem e dois
+// toques rápidos (a partir de ~2 x BUTTON_DEBOUNCE_MS) contam os dois. Com o botão
+// seguro, gera BUTTON_LONG uma vez após BUTTON_LONG_MS e depois BUTTON_REPEAT a cada
+// BUTTON_REPEAT_MS. O alarme só fica armado enquanto há nível por confirmar ou botão
+// seguro, e então roda pelo menos a cada BUTTON_TICK_MS (uma borda nova não reprograma
+// o alarme já armado); parado, não acorda o laço.
+//
+// Cada fila tem um produtor e um consumidor (índices livres de 32 bits, barreiras como
+// em record.h). A interrupção do GPIO e a do alarme rodam no mesmo núcleo, com a mesma
+// prioridade: uma não interrompe a outra, e o estado do debouncer não precisa de trava.
+
+#define BUTTONS_MAX 4               // Botões por debouncer
+#define BUTTON_QUEUE 32             // Entradas em cada fila (potência de 2)
+#define BUTTON_DEBOUNCE_MS 10       // Tempo sem bordas para aceitar um nível
+#define BUTTON_TICK_MS 5            // Maior intervalo do alarme com o debouncer ativo
+#define BUTTON_LONG_MS 600          // Botão seguro até o toque longo
+#define BUTTON_REPEAT_MS 150        // Intervalo da repetição depois do toque longo
+
+typedef enum {
+    BUTTON_PRESS,                   // Aperto (na fila de bordas: nível pressionado)
+    BUTTON_RELEASE,                 // Soltura (na fila de bordas: nível solto)
+    BUTTON_LONG,                    // Seguro por BUTTON_LONG_MS
+    BUTTON_REPEAT                   // Ainda seguro, a cada BUTTON_REPEAT_MS
+} button_action_t;
+
+typedef struct {
+    uint32_t t_us;                  // Instante (us desde o boot, volta a zero a cada ~71 min)
+    uint8_t button;                 // Índice do botão (ordem de hal_button_t)
+    uint8_t action;                 // button_action_t
+} button_event_t;
+
+typedef struct {
+    volatile uint32_t head;         // Escrito só pelo produtor
+    volatile uint32_t tail;         // Escrito só pelo consumidor
+    uint32_t dropped;               // Entradas descartadas com a fila cheia
+    button_event_t slots[BUTTON_QUEUE];
+} button_queue_t;
+
+// Estado de um botão no debouncer
+typedef struct {
+    bool level;                     // Último nível recebido (pressionado = true)
+    bool settling;                  // Há borda ainda não confirmada
+    bool pressed;                   // Nível aceito
+    bool held;                      // BUTTON_LONG já enviado neste aperto
+    uint32_t edge_us;               // Instante da última borda
+    uint32_t hold_us;               // Próximo BUTTON_LONG ou BUTTON_REPEAT
+} button_state_t;
+
+typedef struct {
+    uint8_t count;                  // Botões em uso
+    volatile bool idle;             // Alarme desarmado
+    button_queue_t edges;           // Interrupção do GPIO -> debouncer
+    button_queue_t events;          // Debouncer -> laço principal
+    button_state_t state[BUTTONS_MAX];
+} buttons_t;
+
+void buttons_init(buttons_t *bt, uint8_t count);
+
+// Interrupção do GPIO: registra o nível lido no pino. Retorna true se o debouncer
+// estava parado; o chamador então arma o alarme para BUTTON_DEBOUNCE_MS.
+bool buttons_edge(buttons_t *bt, uint8_t button, bool pressed, uint32_t t_us);
+
+// O alarme pedido por buttons_edge() não pôde ser armado: o debouncer volta a ficar
+// parado (a borda segue na fila) e a próxima borda tenta armar de novo
+void buttons_alarm_failed(buttons_t *bt);
+
+// Alarme: consome as bordas e gera os eventos vencidos até now_us. Retorna o atraso
+// até a próxima chamada (us), ou 0 se não há mais nada a esperar (o debouncer para).
+uint32_t buttons_update(buttons_t *bt, uint32_t now_us);
+
+// Laço principal: próximo evento; false se a fila está vazia
+bool buttons_next(buttons_t *bt, button_event_t *event);
+
+#endif // BUTTONS_H
@@ -0,0 +1,141 @@
+#include "capture.h"
+#include <string.h>
+
+#ifndef AFINADOR_HOST
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#endif
+
+// Reinicia os contadores do ping-pong
+void capture_reset(capture_t *cap, uint32_t sample_rate) {
+    memset(cap->blocks, 0, sizeof(cap->blocks));
+    cap->produced = 0;
+    cap->consumed = 0;
+    cap->overruns = 0;
+    cap->fill_pos = 0;
+    cap->sample_rate = sample_rate;
+}
+
+// Chamado (na interrupção da DMA) quando uma metade do buffer termina de ser preenchida
+void capture_block_complete(capture_t *cap) {
+    cap->produced = cap->produced + 1;
+}
+
+// Obtém o bloco mais antigo ainda não analisado.
+// Se o consumidor ficou para trás mais de um bloco, os dados antigos já foram
+// sobrescritos pela DMA: pula para o último bloco completo e conta o overrun.
+bool capture_acquire(capture_t *cap, const uint16_t **block, uint32_t *seq) {
+    uint32_t produced = cap->produced;
+    if (produced == cap->consumed) return false;  // Nenhum bloco novo
+
+    if (produced - cap->consumed > 1) {
+        cap->overruns += produced - cap->consumed - 1;
+        cap->consumed = produced - 1;
+    }
+
+    *block = cap->blocks[cap->consumed & 1];
+    if (seq) *seq = cap->consumed;
+    return true;
+}
+
+// Libera o bloco obtido por capture_acquire() para ser reutilizado pela DMA
+void capture_release(capture_t *cap) {
+    // Se dois blocos foram concluídos durante a análise, o bloco analisado
+    // estava sendo sobrescrito enquanto era lido
+    if (cap->produced - cap->consumed > 1) {
+        cap->overruns++;
+    }
+    cap->consumed++;
+}
+
+// Alimenta a captura por software, imitando a DMA (usado no host e em testes)
+void capture_feed(capture_t *cap, const uint16_t *samples, uint32_t count) {
+    while (count > 0) {
+        uint16_t *dst = cap->blocks[cap->produced & 1];
+        uint32_t n = CAPTURE_BLOCK_SIZE - cap->fill_pos;
+        if (n > count) n = count;
+
+        memcpy(&dst[cap->fill_pos], samples, n * sizeof(uint16_t));
+        cap->fill_pos += n;
+        samples += n;
+        count -= n;
+
+        if (cap->fill_pos == CAPTURE_BLOCK_SIZE) {
+            cap->fill_pos = 0;
+            capture_block_complete(cap);
+        }
+    }
+}
+
+#ifndef AFINADOR_HOST
+
+#define ADC_CLOCK_HZ 48000000  // clk_adc fixo em 48 MHz (PLL USB)
+
+static capture_t *active_capture = NULL;  // Captura atendida pela interrupção
+static int dma_chan[2] = {-1, -1};        // Um canal de DMA por metade do ping-pong
+
+// Interrupção da DMA: rearma o canal que terminou e entrega o bloco ao laço principal.
+// O canal seguinte já foi disparado pelo encadeamento, então nenhuma amostra é perdida.
+static void capture_dma_irq_handler(void) {
+    for (int i = 0; i < 2; i++) {
+        uint ch = (uint)dma_chan[i];
+        if (dma_channel_get_irq0_status(ch)) {
+            dma_channel_acknowledge_irq0(ch);
+            dma_channel_set_write_addr(ch, active_capture->blocks[i], false);
+            capture_block_complete(active_capture);
+        }
+    }
+}
+
+void capture_start(capture_t *cap, unsigned int adc_input, uint32_t sample_rate) {
+    capture_reset(cap, sample_rate);
+    active_capture = cap;
+
+    // ADC em modo free-running, cadenciado pelo próprio divisor de clock
+    adc_select_input(adc_input);
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_set_clkdiv((float)ADC_CLOCK_HZ / sample_rate - 1.0f);
+
+    dma_chan[0] = dma_claim_unused_channel(true);
+    dma_chan[1] = dma_claim_unused_channel(true);
+
+    // Cada canal preenche uma metade e, ao terminar, dispara o outro
+    for (int i = 0; i < 2; i++) {
+        dma_channel_config config = dma_channel_get_default_config(dma_chan[i]);
+        channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+        channel_config_set_read_increment(&config, false);
+        channel_config_set_write_increment(&config, true);
+        channel_config_set_dreq(&config, DREQ_ADC);
+        channel_config_set_chain_to(&config, dma_chan[i ^ 1]);
+        dma_channel_configure(dma_chan[i], &config, cap->blocks[i], &adc_hw->fifo,
+                              CAPTURE_BLOCK_SIZE, false);
+        dma_channel_set_irq0_enabled(dma_chan[i], true);
+    }
+
+    irq_add_shared_handler(DMA_IRQ_0, capture_dma_irq_handler,
+                           PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+
+    dma_channel_start(dma_chan[0]);
+    adc_run(true);
+}
+
+void capture_stop(capture_t *cap) {
+    (void)cap;
+    adc_run(false);
+
+    for (int i = 0; i < 2; i++) {
+        dma_channel_set_irq0_enabled(dma_chan[i], false);
+        dma_channel_abort(dma_chan[i]);
+        dma_channel_acknowledge_irq0(dma_chan[i]);
+        dma_channel_unclaim(dma_chan[i]);
+        dma_chan[i] = -1;
+    }
+    irq_remove_handler(DMA_IRQ_0, capture_dma_irq_handler);
+
+    adc_fifo_drain();
+    active_capture = NULL;
+}
+
+#endif // AFINADOR_HOST
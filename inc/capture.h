@@ -0,0 +1,36 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Número de amostras em cada metade do buffer ping-pong
+#ifndef CAPTURE_BLOCK_SIZE
+#define CAPTURE_BLOCK_SIZE 512
+#endif
+
+// Estado da captura contínua do ADC.
+// A DMA preenche blocks[produced & 1] enquanto o laço principal analisa blocks[consumed & 1].
+typedef struct {
+    uint16_t blocks[2][CAPTURE_BLOCK_SIZE]; // Buffers ping-pong
+    volatile uint32_t produced;             // Blocos completos entregues pela DMA
+    uint32_t consumed;                      // Blocos já liberados pelo consumidor
+    volatile uint32_t overruns;             // Blocos sobrescritos antes de serem analisados
+    uint32_t fill_pos;                      // Posição de escrita usada por capture_feed()
+    uint32_t sample_rate;                   // Taxa de amostragem efetiva (Hz)
+} capture_t;
+
+// Núcleo portátil (usado pelo firmware e pelos testes no host)
+void capture_reset(capture_t *cap, uint32_t sample_rate);
+void capture_block_complete(capture_t *cap);
+bool capture_acquire(capture_t *cap, const uint16_t **block, uint32_t *seq);
+void capture_release(capture_t *cap);
+void capture_feed(capture_t *cap, const uint16_t *samples, uint32_t count);
+
+#ifndef AFINADOR_HOST
+// Backend de hardware: ADC em modo free-running alimentando dois canais de DMA encadeados
+void capture_start(capture_t *cap, unsigned int adc_input, uint32_t sample_rate);
+void capture_stop(capture_t *cap);
+#endif
+
+#endif // CAPTURE_H
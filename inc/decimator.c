@@ -0,0 +1,96 @@
+#include "decimator.h"
+#include <string.h>
+
+#define ADC_MIDSCALE 2048
+#define FRACTION_BITS 2   // Bits fracionários entre os estágios (a decimação ganha resolução)
+
+// Meia-banda de 15 coeficientes (janela de Kaiser, Q15): os de índice par são nulos,
+// exceto o central (0,5). Ondulação na banda passante < 0,02 dB até 0,125 fs e
+// atenuação > 53 dB a partir de 0,375 fs. Ganho DC exatamente 1.
+#define HB_CENTER 16384
+static const int16_t hb_taps[4] = {9948, -2266, 565, -55};  // Distâncias 1, 3, 5 e 7 do centro
+
+bool decimator_init(decimator_t *d, uint32_t input_rate, uint32_t output_rate) {
+    memset(d, 0, sizeof(*d));
+    if (output_rate == 0 || input_rate % output_rate != 0) return false;
+
+    // Usa os meia-banda para os fatores 2 finais (filtros mais seletivos na taxa baixa)
+    // e o CIC para o restante, na taxa alta, onde só há somas
+    uint32_t ratio = input_rate / output_rate;
+    uint8_t halfbands = 0;
+    while (halfbands < DECIMATOR_MAX_HALFBANDS && (ratio & 1) == 0) {
+        ratio >>= 1;
+        halfbands++;
+    }
+    if (ratio > DECIMATOR_MAX_CIC_RATIO) return false;
+
+    d->input_rate = input_rate;
+    d->output_rate = output_rate;
+    d->cic_ratio = (uint8_t)ratio;
+    d->halfbands = halfbands;
+
+    // Ganho do CIC: R^3. cic_scale = 2^(16 + FRACTION_BITS) / R^3, arredondado
+    uint32_t gain = ratio * ratio * ratio;
+    d->cic_scale = (int32_t)(((1u << (16 + FRACTION_BITS)) + gain / 2) / gain);
+    return true;
+}
+
+// Empurra uma amostra num meia-banda; retorna true (e grava *y) a cada duas entradas
+static inline bool halfband_push(decimator_halfband_t *hb, int16_t x, int16_t *y) {
+    hb->delay[hb->pos] = x;
+    hb->delay[hb->pos + DECIMATOR_HALFBAND_TAPS] = x;
+    if (++hb->pos == DECIMATOR_HALFBAND_TAPS) hb->pos = 0;
+
+    hb->odd = !hb->odd;
+    if (hb->odd) return false;
+
+    // w[0] é a amostra mais antiga e w[14] a mais recente; o centro é w[7]
+    const int16_t *w = &hb->delay[hb->pos];
+    int32_t acc = HB_CENTER * w[7]
+                + hb_taps[0] * (w[6] + w[8])
+                + hb_taps[1] * (w[4] + w[10])
+                + hb_taps[2] * (w[2] + w[12])
+                + hb_taps[3] * (w[0] + w[14]);
+    *y = (int16_t)((acc + (1 << 14)) >> 15);
+    return true;
+}
+
+uint32_t decimator_process(decimator_t *d, const uint16_t *in, uint32_t count, uint16_t *out) {
+    uint32_t produced = 0;
+    uint32_t i0 = d->integrator[0], i1 = d->integrator[1], i2 = d->integrator[2];
+
+    for (uint32_t n = 0; n < count; n++) {
+        // Integradores do CIC na taxa de entrada
+        i0 += (uint32_t)((int32_t)in[n] - ADC_MIDSCALE);
+        i1 += i0;
+        i2 += i1;
+        if (++d->cic_phase < d->cic_ratio) continue;
+        d->cic_phase = 0;
+
+        // Pentes na taxa decimada
+        uint32_t v = i2;
+        for (uint8_t k = 0; k < DECIMATOR_CIC_ORDER; k++) {
+            uint32_t t = v - d->comb[k];
+            d->comb[k] = v;
+            v = t;
+        }
+        int16_t x = (int16_t)(((int32_t)v * d->cic_scale) >> 16);
+
+        // Meia-banda em cascata: cada um consome duas amostras por saída
+        bool ready = true;
+        for (uint8_t s = 0; s < d->halfbands && ready; s++) {
+            ready = halfband_push(&d->stage[s], x, &x);
+        }
+        if (!ready) continue;
+
+        int32_t y = ((x + (1 << (FRACTION_BITS - 1))) >> FRACTION_BITS) + ADC_MIDSCALE;
+        if (y < 0) y = 0;
+        if (y > 4095) y = 4095;
+        out[produced++] = (uint16_t)y;
+    }
+
+    d->integrator[0] = i0;
+    d->integrator[1] = i1;
+    d->integrator[2] = i2;
+    return produced;
+}
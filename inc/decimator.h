@@ -0,0 +1,47 @@
+#ifndef DECIMATOR_H
+#define DECIMATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Decimador em ponto fixo para a captura sobreamostrada.
+// Estágios: CIC de 3ª ordem (razão R, sem multiplicações) seguido de até dois filtros
+// meia-banda polifásicos de 15 coeficientes (cada um divide a taxa por 2).
+// A razão total é R x 2^H; ex.: 64 kHz -> 4 kHz usa R = 4 e dois meia-banda.
+// A faixa de 0 a 1 kHz (onde o detector procura) passa com menos de 0,2 dB de queda,
+// e o que dobraria sobre ela é atenuado em pelo menos ~50 dB.
+
+#define DECIMATOR_CIC_ORDER 3
+#define DECIMATOR_MAX_CIC_RATIO 32
+#define DECIMATOR_MAX_HALFBANDS 2
+#define DECIMATOR_HALFBAND_TAPS 15
+
+// Um estágio meia-banda: linha de atraso espelhada (janela sempre contígua)
+typedef struct {
+    int16_t delay[2 * DECIMATOR_HALFBAND_TAPS];
+    uint8_t pos;     // Próxima posição de escrita
+    bool odd;        // Fase do polifásico: calcula uma saída a cada duas entradas
+} decimator_halfband_t;
+
+typedef struct {
+    uint32_t input_rate;    // Taxa do ADC (Hz)
+    uint32_t output_rate;   // Taxa entregue ao detector (Hz)
+    uint8_t cic_ratio;      // Razão do CIC (R)
+    uint8_t cic_phase;      // Amostras acumuladas desde a última saída do CIC
+    uint8_t halfbands;      // Estágios meia-banda (H)
+    int32_t cic_scale;      // Normaliza o ganho R^3 do CIC (Q16, com 2 bits fracionários a mais)
+    uint32_t integrator[DECIMATOR_CIC_ORDER];  // Aritmética modular: o estouro é intencional
+    uint32_t comb[DECIMATOR_CIC_ORDER];
+    decimator_halfband_t stage[DECIMATOR_MAX_HALFBANDS];
+} decimator_t;
+
+// Configura o decimador; retorna false se input_rate / output_rate não for um inteiro
+// decomponível em R x 2^H (R <= DECIMATOR_MAX_CIC_RATIO, H <= DECIMATOR_MAX_HALFBANDS).
+bool decimator_init(decimator_t *d, uint32_t input_rate, uint32_t output_rate);
+
+// Filtra e decima amostras do ADC (12 bits). Grava em out as amostras na taxa de saída,
+// na mesma escala de 12 bits centrada em 2048, e retorna quantas foram geradas
+// (no máximo count / razão + 1).
+uint32_t decimator_process(decimator_t *d, const uint16_t *in, uint32_t count, uint16_t *out);
+
+#endif // DECIMATOR_H
@@ -0,0 +1,196 @@
+#include "fft.h"
+#include <math.h>
+
+// Twiddles W^k = cos(2*pi*k/FFT_MAX_SIZE) - j*sin(2*pi*k/FFT_MAX_SIZE) em Q15.
+// Planos menores percorrem a mesma tabela com passo FFT_MAX_SIZE / N.
+static int16_t twiddle_cos[FFT_MAX_SIZE / 2];
+static int16_t twiddle_sin[FFT_MAX_SIZE / 2];
+static bool twiddles_ready = false;
+
+static int16_t work[FFT_MAX_SIZE];         // Bloco de trabalho de fft_detect_fundamental()
+static uint16_t spectrum[FFT_MAX_SIZE / 2]; // Módulos do último quadro
+
+static void fft_build_twiddles(void) {
+    for (uint32_t k = 0; k < FFT_MAX_SIZE / 2; k++) {
+        float angle = 6.28318530718f * (float)k / FFT_MAX_SIZE;
+        twiddle_cos[k] = (int16_t)lrintf(cosf(angle) * 32767.0f);
+        twiddle_sin[k] = (int16_t)lrintf(sinf(angle) * 32767.0f);
+    }
+    twiddles_ready = true;
+}
+
+bool fft_plan_init(fft_plan_t *plan, uint16_t size) {
+    if (size != 256 && size != 512 && size != 1024 && size != 2048) return false;
+    if (!twiddles_ready) fft_build_twiddles();
+
+    uint32_t half = size / 2;
+    uint8_t bits = 0;
+    while ((1u << bits) < half) bits++;
+
+    plan->size = size;
+    plan->log2_half = bits;
+
+    for (uint32_t i = 0; i < half; i++) {
+        uint32_t r = 0;
+        for (uint8_t b = 0; b < bits; b++) {
+            if (i & (1u << b)) r |= 1u << (bits - 1 - b);
+        }
+        plan->bitrev[i] = (uint16_t)r;
+    }
+    return true;
+}
+
+// FFT complexa radix-2 (dizimação no tempo) sobre N/2 pares (re, im)
+static void fft_complex(const fft_plan_t *plan, int16_t *data) {
+    uint32_t half = plan->size / 2;
+
+    // Permutação por reversão de bits
+    for (uint32_t i = 0; i < half; i++) {
+        uint32_t j = plan->bitrev[i];
+        if (j > i) {
+            int16_t tr = data[2 * i], ti = data[2 * i + 1];
+            data[2 * i] = data[2 * j];
+            data[2 * i + 1] = data[2 * j + 1];
+            data[2 * j] = tr;
+            data[2 * j + 1] = ti;
+        }
+    }
+
+    // Borboletas com divisão por 2 em cada estágio
+    for (uint32_t span = 2; span <= half; span <<= 1) {
+        uint32_t step = FFT_MAX_SIZE / span;
+        uint32_t hspan = span >> 1;
+        for (uint32_t j = 0; j < hspan; j++) {
+            int32_t wr = twiddle_cos[j * step];
+            int32_t wi = twiddle_sin[j * step];
+            for (uint32_t i = j; i < half; i += span) {
+                int16_t *u = &data[2 * i];
+                int16_t *v = &data[2 * (i + hspan)];
+                int32_t tr = (wr * v[0] + wi * v[1]) >> 15;
+                int32_t ti = (wr * v[1] - wi * v[0]) >> 15;
+                int32_t ur = u[0], ui = u[1];
+                u[0] = (int16_t)((ur + tr) >> 1);
+                u[1] = (int16_t)((ui + ti) >> 1);
+                v[0] = (int16_t)((ur - tr) >> 1);
+                v[1] = (int16_t)((ui - ti) >> 1);
+            }
+        }
+    }
+}
+
+void fft_real_forward(const fft_plan_t *plan, int16_t *data) {
+    uint32_t half = plan->size / 2;
+    uint32_t step = FFT_MAX_SIZE / plan->size;
+
+    // Amostras pares/ímpares viram as partes real/imaginária de z[n]
+    fft_complex(plan, data);
+
+    // Separação: X[k] = Fe[k] + W_N^k Fo[k]; X[N/2-k] = conj(Fe[k] - W_N^k Fo[k])
+    int32_t z0r = data[0], z0i = data[1];
+    data[0] = (int16_t)((z0r + z0i) >> 1);  // DC
+    data[1] = (int16_t)((z0r - z0i) >> 1);  // Nyquist
+
+    for (uint32_t k = 1; k <= half / 2; k++) {
+        int16_t *a = &data[2 * k];
+        int16_t *b = &data[2 * (half - k)];
+
+        int32_t fer = (a[0] + b[0]) >> 1;
+        int32_t fei = (a[1] - b[1]) >> 1;
+        int32_t for_ = (a[1] + b[1]) >> 1;
+        int32_t foi = (b[0] - a[0]) >> 1;
+
+        int32_t wr = twiddle_cos[k * step];
+        int32_t wi = twiddle_sin[k * step];
+        int32_t tr = (wr * for_ + wi * foi) >> 15;
+        int32_t ti = (wr * foi - wi * for_) >> 15;
+
+        a[0] = (int16_t)((fer + tr) >> 1);
+        a[1] = (int16_t)((fei + ti) >> 1);
+        if (b != a) {
+            b[0] = (int16_t)((fer - tr) >> 1);
+            b[1] = (int16_t)((ti - fei) >> 1);
+        }
+    }
+}
+
+// Raiz quadrada inteira (método dígito a dígito)
+static uint32_t fft_isqrt(uint32_t value) {
+    uint32_t root = 0;
+    uint32_t bit = 1u << 30;
+    while (bit > value) bit >>= 2;
+    while (bit) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+void fft_magnitude(const fft_plan_t *plan, const int16_t *data, uint16_t *mag) {
+    uint32_t half = plan->size / 2;
+    mag[0] = (uint16_t)(data[0] < 0 ? -data[0] : data[0]);
+    for (uint32_t k = 1; k < half; k++) {
+        int32_t re = data[2 * k], im = data[2 * k + 1];
+        mag[k] = (uint16_t)fft_isqrt((uint32_t)(re * re) + (uint32_t)(im * im));
+    }
+}
+
+fixed_t fft_hps_fundamental(const uint16_t *mag, uint32_t bins, uint32_t min_bin, uint32_t max_bin) {
+    if (min_bin < 1) min_bin = 1;
+    if (max_bin > (bins - 1) / FFT_HPS_HARMONICS) max_bin = (bins - 1) / FFT_HPS_HARMONICS;
+
+    uint64_t best = 0;
+    uint32_t best_bin = 0;
+    for (uint32_t k = min_bin; k <= max_bin; k++) {
+        uint64_t product = mag[k];
+        for (uint32_t h = 2; h <= FFT_HPS_HARMONICS; h++) {
+            // O harmônico h cai a até h/2 bins de h*k: usa o maior vizinho
+            uint32_t c = h * k;
+            uint16_t m = mag[c];
+            if (mag[c - 1] > m) m = mag[c - 1];
+            if (c + 1 < bins && mag[c + 1] > m) m = mag[c + 1];
+            product *= m;
+        }
+        if (product > best) {
+            best = product;
+            best_bin = k;
+        }
+    }
+    if (best_bin == 0) return 0;
+
+    // Interpola no próprio bin da fundamental. Não recentra no harmônico mais forte:
+    // num tom puro o "harmônico" de best_bin / 2 é a própria nota, e o resultado
+    // cairia uma oitava abaixo.
+    int32_t a = mag[best_bin - 1], b = mag[best_bin], c = mag[best_bin + 1];
+    int32_t denom = a - 2 * b + c;
+    int32_t delta = (denom < 0) ? (int32_t)(((int64_t)(a - c) << 15) / denom) : 0;  // Q16
+    if (delta > FIXED_ONE / 2) delta = FIXED_ONE / 2;
+    if (delta < -FIXED_ONE / 2) delta = -FIXED_ONE / 2;
+    return (fixed_t)(((int32_t)best_bin << FIXED_SHIFT) + delta);
+}
+
+uint16_t fft_spectrum_level(const fft_plan_t *plan, fixed_t frequency, uint32_t sample_rate) {
+    uint32_t bin = (uint32_t)(((int64_t)frequency * plan->size / sample_rate + FIXED_ONE / 2) >> FIXED_SHIFT);
+    return (bin < plan->size / 2u) ? spectrum[bin] : 0;
+}
+
+fixed_t fft_detect_fundamental(const fft_plan_t *plan, const int16_t *centered, uint32_t sample_rate,
+                               uint32_t min_freq, uint32_t max_freq) {
+    uint32_t n = plan->size;
+
+    // A FFT é feita no lugar: copia o bloco (já sem DC) com 15 bits de faixa dinâmica
+    for (uint32_t i = 0; i < n; i++) work[i] = (int16_t)(centered[i] * 8);
+
+    fft_real_forward(plan, work);
+    fft_magnitude(plan, work, spectrum);
+
+    uint32_t min_bin = min_freq * n / sample_rate;
+    uint32_t max_bin = max_freq * n / sample_rate + 1;
+    fixed_t bin = fft_hps_fundamental(spectrum, n / 2, min_bin, max_bin);
+
+    return (fixed_t)(((int64_t)bin * sample_rate) / n);
+}
@@ -0,0 +1,53 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixed.h"
+
+// FFT real radix-2 em ponto fixo (Q15), in-place.
+//
+// Uma FFT real de N pontos é calculada como uma FFT complexa de N/2 pontos
+// seguida de um passo de separação. Cada estágio divide o resultado por 2,
+// então a saída corresponde a X[k] / N e nunca estoura 16 bits.
+//
+// Orçamento estimado no RP2040 (Cortex-M0+, multiplicador de 1 ciclo, -O2),
+// incluindo módulo e produto harmônico de 3 harmônicos:
+//   N =  512:  ~80 mil ciclos por quadro (~0,6 ms a 128 MHz)
+//   N = 1024: ~180 mil ciclos por quadro (~1,4 ms a 128 MHz)
+//   N = 2048: ~400 mil ciclos por quadro (~3,1 ms a 128 MHz)
+
+#define FFT_MAX_SIZE 2048  // Maior FFT suportada (pontos reais)
+#define FFT_HPS_HARMONICS 3 // Harmônicos multiplicados pelo produto harmônico
+
+// Plano de uma FFT: tamanho e tabela de reversão de bits
+typedef struct {
+    uint16_t size;                     // N (pontos reais): 256, 512, 1024 ou 2048
+    uint8_t log2_half;                 // log2(N/2)
+    uint16_t bitrev[FFT_MAX_SIZE / 2]; // Permutação de entrada da FFT complexa
+} fft_plan_t;
+
+// Prepara um plano para N pontos. Também gera (uma única vez) as tabelas de twiddles.
+bool fft_plan_init(fft_plan_t *plan, uint16_t size);
+
+// Transforma N amostras reais em N/2 bins complexos intercalados (re, im), in-place.
+// O bin 0 guarda DC em data[0] e o bin de Nyquist em data[1].
+void fft_real_forward(const fft_plan_t *plan, int16_t *data);
+
+// Módulo dos bins 0..N/2-1 (mag[0] = |DC|)
+void fft_magnitude(const fft_plan_t *plan, const int16_t *data, uint16_t *mag);
+
+// Produto harmônico (HPS): procura, entre min_bin e max_bin, o bin cujo produto dos
+// módulos em k, 2k, ..., FFT_HPS_HARMONICS*k é máximo. Retorna o bin fracionário
+// da fundamental (Q16.16, interpolação parabólica) ou 0 se não houver energia.
+fixed_t fft_hps_fundamental(const uint16_t *mag, uint32_t bins, uint32_t min_bin, uint32_t max_bin);
+
+// Pipeline completo: bloco sem DC (ver level.h) -> frequência fundamental (Hz, Q16.16) pelo HPS
+fixed_t fft_detect_fundamental(const fft_plan_t *plan, const int16_t *centered, uint32_t sample_rate,
+                               uint32_t min_freq, uint32_t max_freq);
+
+// Módulo do bin mais próximo de `frequency` (Hz, Q16.16) no espectro calculado pela
+// última chamada a fft_detect_fundamental (mesmo plano e taxa)
+uint16_t fft_spectrum_level(const fft_plan_t *plan, fixed_t frequency, uint32_t sample_rate);
+
+#endif // FFT_H
@@ -0,0 +1,93 @@
+#include "fixed.h"
+
+static const uint32_t powers_of_ten[5] = {1, 10, 100, 1000, 10000};
+
+#define CENTS_PER_NEPER 113458155       // 1200 / ln(2) em Q16
+#define CORDIC_ITERATIONS 16
+
+// atan(2^-i) em voltas x 2^32
+static const uint32_t atan_turns[CORDIC_ITERATIONS] = {
+    536870912u, 316933406u, 167458907u, 85004756u, 42667331u, 21354465u, 10679838u, 5340245u,
+    2670163u, 1335087u, 667544u, 333772u, 166886u, 83443u, 41722u, 20861u
+};
+
+fixed_t fixed_cents(fixed_t offset, fixed_t reference) {
+    int64_t x = ((int64_t)offset << 30) / reference;  // Q30
+    int64_t ln = x - (((x * x) >> 30) >> 1);
+    return (fixed_t)((ln * CENTS_PER_NEPER) >> 30);
+}
+
+// CORDIC em modo vetorial: gira (x, y) até o eixo x somando os ângulos usados
+uint32_t fixed_atan2(int32_t y, int32_t x, int32_t *magnitude) {
+    uint32_t angle = 0;
+    if (x < 0) {
+        x = -x;
+        y = -y;
+        angle = 0x80000000u;
+    }
+    for (uint32_t i = 0; i < CORDIC_ITERATIONS; i++) {
+        int32_t dx = x >> i, dy = y >> i;
+        if (y > 0) {
+            x += dy;
+            y -= dx;
+            angle += atan_turns[i];
+        } else {
+            x -= dy;
+            y += dx;
+            angle -= atan_turns[i];
+        }
+    }
+    if (magnitude) *magnitude = x;
+    return angle;
+}
+
+// Escreve um inteiro sem sinal (dígitos em ordem inversa e depois invertidos)
+static char *append_unsigned(char *out, uint32_t value) {
+    char digits[10];
+    uint8_t n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    while (n > 0) *out++ = digits[--n];
+    *out = '\0';
+    return out;
+}
+
+char *fixed_append_int(char *out, int32_t value, bool plus_sign) {
+    uint32_t magnitude = (uint32_t)value;
+    if (value < 0) {
+        *out++ = '-';
+        magnitude = 0u - magnitude;
+    } else if (plus_sign) {
+        *out++ = '+';
+    }
+    return append_unsigned(out, magnitude);
+}
+
+char *fixed_append(char *out, fixed_t value, uint8_t decimals) {
+    if (decimals > 4) decimals = 4;
+    uint32_t scale = powers_of_ten[decimals];
+
+    // Arredonda |valor| x 10^d para o inteiro mais próximo e separa parte inteira e casas
+    uint64_t magnitude = (value < 0) ? (uint64_t)(-(int64_t)value) : (uint64_t)value;
+    uint64_t scaled = (magnitude * scale + (FIXED_ONE >> 1)) >> FIXED_SHIFT;
+
+    if (value < 0 && scaled > 0) *out++ = '-';
+    out = append_unsigned(out, (uint32_t)(scaled / scale));
+    if (decimals == 0) return out;
+
+    *out++ = '.';
+    uint32_t fraction = (uint32_t)(scaled % scale);
+    for (uint32_t div = scale / 10; div > 0; div /= 10) {
+        *out++ = (char)('0' + (fraction / div) % 10);
+    }
+    *out = '\0';
+    return out;
+}
+
+char *fixed_append_str(char *out, const char *str) {
+    while (*str) *out++ = *str++;
+    *out = '\0';
+    return out;
+}
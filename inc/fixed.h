@@ -0,0 +1,61 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Aritmética em ponto fixo para o caminho do afinador (o RP2040 não tem FPU).
+//   fixed_t: Q16.16, para frequências (Hz) e cents. Faixa de +-32767 com passo de 1/65536.
+//   q15_t:   Q1.15, para fatores em [0, 1) como clareza e suavização.
+// As multiplicações usam produtos de 64 bits; as divisões ficam fora dos laços internos.
+
+typedef int32_t fixed_t;
+typedef int16_t q15_t;
+
+#define FIXED_SHIFT 16
+#define FIXED_ONE (1 << FIXED_SHIFT)
+#define Q15_ONE 32767
+
+// Conversões de constantes (avaliadas na compilação; não usar com variáveis no firmware)
+#define FIXED_FROM_INT(n) ((fixed_t)(n) * FIXED_ONE)
+#define FIXED_CONST(x) ((fixed_t)((x) * 65536.0 + ((x) >= 0 ? 0.5 : -0.5)))
+#define Q15_CONST(x) ((q15_t)((x) * 32768.0 + 0.5))
+
+static inline fixed_t fixed_mul(fixed_t a, fixed_t b) {
+    return (fixed_t)(((int64_t)a * b) >> FIXED_SHIFT);
+}
+
+static inline fixed_t fixed_div(fixed_t a, fixed_t b) {
+    return (fixed_t)(((int64_t)a << FIXED_SHIFT) / b);
+}
+
+static inline fixed_t fixed_mul_q15(fixed_t a, q15_t b) {
+    return (fixed_t)(((int64_t)a * b) >> 15);
+}
+
+static inline fixed_t fixed_abs(fixed_t a) {
+    return a < 0 ? -a : a;
+}
+
+// Inteiro mais próximo (meios arredondados para cima)
+static inline int32_t fixed_round(fixed_t a) {
+    return (a + (FIXED_ONE >> 1)) >> FIXED_SHIFT;
+}
+
+// Desvio em cents de reference + offset em relação a reference (Hz, Q16.16), para
+// |offset| < 3% de reference: 1200 log2(1 + x) com ln(1 + x) ~ x - x^2 / 2
+fixed_t fixed_cents(fixed_t offset, fixed_t reference);
+
+// Ângulo de (x, y) em voltas x 2^32 (CORDIC de 16 iterações, erro < 1e-4 volta).
+// Se magnitude não for NULL, recebe |(x, y)| x FIXED_CORDIC_GAIN (|x|, |y| < 2^29).
+#define FIXED_CORDIC_GAIN FIXED_CONST(1.646760258)
+uint32_t fixed_atan2(int32_t y, int32_t x, int32_t *magnitude);
+
+// Formatação sem printf nem float. Cada função escreve a partir de out, termina a
+// string com '\0' e retorna o ponteiro para esse '\0', para encadear chamadas.
+// O chamador garante o espaço (um fixed_t com 2 casas cabe em 10 caracteres).
+char *fixed_append(char *out, fixed_t value, uint8_t decimals);   // ex.: "110.25"
+char *fixed_append_int(char *out, int32_t value, bool plus_sign); // ex.: "+12"
+char *fixed_append_str(char *out, const char *str);
+
+#endif // FIXED_H
@@ -0,0 +1,93 @@
+#ifndef HAL_H
+#define HAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "capture.h"
+
+// Camada de abstração do hardware usada pelo laço do firmware (main.c) e pelos
+// drivers do OLED e da matriz WS2812.
+//
+// No firmware (hal_pico.c) cada função é uma chamada direta ao Pico SDK. No host
+// (host/hal_host.c) o mesmo laço roda contra um simulador: o microfone é um WAV,
+// os botões vêm de um roteiro, o OLED, a matriz e o LED RGB são registradores
+// virtuais, e o tempo é virtual (avança até o próximo evento quando o laço dorme).
+
+#ifdef AFINADOR_HOST
+// Tipos do SDK que aparecem nas interfaces dos drivers
+typedef unsigned int uint;
+typedef struct i2c_inst i2c_inst_t;
+typedef struct pio_hw pio_hw_t;
+typedef pio_hw_t *PIO;
+#define pio0 ((PIO)0)
+#define i2c1 ((i2c_inst_t *)0)
+#else
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "hardware/gpio.h"
+#include "hardware/adc.h"
+#include "hardware/i2c.h"
+#include "hardware/sync.h"
+#endif
+
+// Botões, na ordem passada a hal_buttons_init (o roteiro do simulador usa os nomes)
+typedef enum {
+    HAL_BUTTON_A,
+    HAL_BUTTON_B,
+    HAL_BUTTON_JOYSTICK,
+    HAL_BUTTONS
+} hal_button_t;
+
+// Chamado na interrupção de qualquer borda, com o botão e o nível lido no pino
+// (pressionado = true); o repique chega como várias chamadas seguidas
+typedef void (*hal_button_callback_t)(hal_button_t button, bool pressed);
+
+// Chamado na interrupção do alarme; retorna o atraso até a próxima chamada (us) ou 0
+// para desarmar
+typedef uint32_t (*hal_alarm_callback_t)(void);
+
+// Tempo desde o boot (us)
+uint64_t hal_time_us(void);
+
+// Espera ativa até o instante dado (us desde o boot)
+void hal_busy_wait_until_us(uint64_t deadline_us);
+
+// Dorme até a próxima interrupção (WFE) ou, com timeout, no máximo timeout_us
+void hal_wait_for_event(void);
+void hal_wait_for_event_timeout_us(uint32_t timeout_us);
+
+// Acorda o outro núcleo em hal_wait_for_event (SEV)
+void hal_notify(void);
+
+// Botões com pull-up e interrupção nas duas bordas
+void hal_buttons_init(const unsigned int pins[HAL_BUTTONS], hal_button_callback_t callback);
+
+// Arma o alarme único para daqui a delay_us, na mesma prioridade da interrupção dos
+// botões; o retorno do callback o rearma. False se não há alarme livre no timer.
+bool hal_alarm_start(uint32_t delay_us, hal_alarm_callback_t callback);
+
+// LED RGB em três pinos digitais
+void hal_rgb_init(unsigned int red_pin, unsigned int green_pin, unsigned int blue_pin);
+void hal_rgb_set(bool red, bool green, bool blue);
+
+// Barramento I2C do OLED
+void hal_oled_bus_init(i2c_inst_t *port, unsigned int sda_pin, unsigned int scl_pin, uint32_t baudrate);
+
+// Microfone: ADC do pino em free-running, entregando blocos a `capture`
+void hal_mic_start(capture_t *capture, unsigned int pin, uint32_t sample_rate);
+
+// Console serial (USB CDC): -1 se não há caractere; `binary` desliga a troca \n -> \r\n
+void hal_console_init(void);
+int hal_console_getc(void);
+void hal_console_binary(bool binary);
+void hal_console_write(const void *data, size_t len);  // Bloqueia enquanto a USB estiver cheia
+
+#ifdef AFINADOR_HOST
+// Registradores virtuais do simulador, chamados pelos backends de host dos drivers.
+// Cada envio retorna o instante (us) em que termina no barramento simulado.
+uint64_t hal_sim_oled_transfer(const uint8_t *screen, uint8_t width, uint8_t pages, size_t bus_bytes);
+uint64_t hal_sim_leds_transfer(const uint32_t *grb, unsigned int count);
+#endif
+
+#endif // HAL_H
@@ -0,0 +1,113 @@
+#include "hal.h"
+#include <stdio.h>
+
+#define ADC_FIRST_GPIO 26  // ADC0 fica no GPIO26; ADC1..3 nos seguintes
+
+static hal_button_callback_t button_callback = NULL;
+static unsigned int button_pins[HAL_BUTTONS];
+static hal_alarm_callback_t alarm_callback = NULL;
+static unsigned int rgb_pins[3];
+
+uint64_t hal_time_us(void) {
+    return time_us_64();
+}
+
+void hal_busy_wait_until_us(uint64_t deadline_us) {
+    busy_wait_until(from_us_since_boot(deadline_us));
+}
+
+void hal_wait_for_event(void) {
+    __wfe();
+}
+
+void hal_wait_for_event_timeout_us(uint32_t timeout_us) {
+    best_effort_wfe_or_timeout(make_timeout_time_us(timeout_us));
+}
+
+void hal_notify(void) {
+    __sev();
+}
+
+// Com o repique, uma interrupção pode trazer as duas bordas juntas: vale o nível do
+// pino agora (pull-up: pressionado = 0), que é o da última borda
+static void hal_gpio_irq(uint gpio, uint32_t events) {
+    (void)events;
+    for (int i = 0; i < HAL_BUTTONS; i++) {
+        if (button_pins[i] == gpio) {
+            if (button_callback) button_callback((hal_button_t)i, !gpio_get(gpio));
+            return;
+        }
+    }
+}
+
+void hal_buttons_init(const unsigned int pins[HAL_BUTTONS], hal_button_callback_t callback) {
+    button_callback = callback;
+    for (int i = 0; i < HAL_BUTTONS; i++) {
+        button_pins[i] = pins[i];
+        gpio_init(pins[i]);
+        gpio_set_dir(pins[i], GPIO_IN);
+        gpio_pull_up(pins[i]);
+        gpio_set_irq_enabled_with_callback(pins[i], GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true, &hal_gpio_irq);
+    }
+}
+
+// Retorno negativo: o SDK reagenda a partir de agora; 0 desarma
+static int64_t hal_alarm_irq(alarm_id_t id, void *user_data) {
+    (void)id;
+    (void)user_data;
+    uint32_t next = alarm_callback ? alarm_callback() : 0;
+    return -(int64_t)next;
+}
+
+bool hal_alarm_start(uint32_t delay_us, hal_alarm_callback_t callback) {
+    alarm_callback = callback;
+    // Negativo: nenhum alarme livre no pool do SDK
+    return add_alarm_in_us(delay_us, hal_alarm_irq, NULL, true) >= 0;
+}
+
+void hal_rgb_init(unsigned int red_pin, unsigned int green_pin, unsigned int blue_pin) {
+    rgb_pins[0] = red_pin;
+    rgb_pins[1] = green_pin;
+    rgb_pins[2] = blue_pin;
+    for (int i = 0; i < 3; i++) {
+        gpio_init(rgb_pins[i]);
+        gpio_set_dir(rgb_pins[i], GPIO_OUT);
+    }
+}
+
+void hal_rgb_set(bool red, bool green, bool blue) {
+    gpio_put(rgb_pins[0], red);
+    gpio_put(rgb_pins[1], green);
+    gpio_put(rgb_pins[2], blue);
+}
+
+void hal_oled_bus_init(i2c_inst_t *port, unsigned int sda_pin, unsigned int scl_pin, uint32_t baudrate) {
+    i2c_init(port, baudrate);
+    gpio_set_function(sda_pin, GPIO_FUNC_I2C);
+    gpio_set_function(scl_pin, GPIO_FUNC_I2C);
+    gpio_pull_up(sda_pin);
+    gpio_pull_up(scl_pin);
+}
+
+void hal_mic_start(capture_t *capture, unsigned int pin, uint32_t sample_rate) {
+    adc_init();
+    adc_gpio_init(pin);
+    capture_start(capture, pin - ADC_FIRST_GPIO, sample_rate);
+}
+
+void hal_console_init(void) {
+    stdio_init_all();
+}
+
+int hal_console_getc(void) {
+    int c = getchar_timeout_us(0);
+    return (c == PICO_ERROR_TIMEOUT) ? -1 : c;
+}
+
+void hal_console_binary(bool binary) {
+    stdio_set_translate_crlf(&stdio_usb, !binary);
+}
+
+void hal_console_write(const void *data, size_t len) {
+    fwrite(data, 1, len, stdout);
+}
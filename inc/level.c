@@ -0,0 +1,85 @@
+#include "level.h"
+
+#define FLOOR_SHIFT 16  // Piso em Q16: passos finos mesmo com blocos curtos e constantes longas
+
+// Raiz quadrada inteira arredondada, bit a bit (uma por bloco)
+static uint32_t level_isqrt(uint32_t value) {
+    uint32_t root = 0, bit = 1u << 30;
+    while (bit > value) bit >>= 2;
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (value > root) ? root + 1 : root;  // Resto acima de root: mais perto de root + 1
+}
+
+void level_init(level_t *lv, uint32_t sample_rate, uint16_t min_level) {
+    lv->sample_rate = sample_rate;
+    lv->min_level = min_level;
+    lv->started = false;
+    lv->dc = 2048 << LEVEL_DC_SHIFT;
+    lv->floor = 0;
+    lv->open = false;
+}
+
+// Aproxima o piso do RMS do bloco com constante de tempo tau_ms, proporcional às
+// amostras do bloco (o mesmo comportamento com blocos de 512 ou saltos de 64)
+static void level_track(level_t *lv, uint32_t rms, uint32_t count, uint32_t tau_ms) {
+    uint32_t target = rms << FLOOR_SHIFT;
+    uint64_t tau = (uint64_t)lv->sample_rate * tau_ms / 1000;
+    if (count >= tau) {
+        lv->floor = target;
+        return;
+    }
+    int64_t delta = (int64_t)target - lv->floor;
+    lv->floor = (uint32_t)(lv->floor + delta * count / (int64_t)tau);
+}
+
+bool level_process(level_t *lv, const uint16_t *samples, uint32_t count, int16_t *centered,
+                   level_reading_t *reading) {
+    // O primeiro bloco fixa o DC pela média; depois ele é seguido amostra a amostra
+    if (!lv->started && count > 0) {
+        uint64_t sum = 0;
+        for (uint32_t n = 0; n < count; n++) sum += samples[n];
+        lv->dc = (int32_t)((sum << LEVEL_DC_SHIFT) / count);
+        lv->started = true;
+    }
+
+    int32_t dc = lv->dc;
+    uint64_t energy = 0;
+    uint32_t peak = 0;
+    for (uint32_t n = 0; n < count; n++) {
+        dc += (((int32_t)samples[n] << LEVEL_DC_SHIFT) - dc) >> LEVEL_DC_SHIFT;
+        int32_t x = (int32_t)samples[n] - ((dc + (1 << (LEVEL_DC_SHIFT - 1))) >> LEVEL_DC_SHIFT);
+        centered[n] = (int16_t)x;
+        energy += (uint32_t)(x * x);
+        uint32_t magnitude = (uint32_t)(x < 0 ? -x : x);
+        if (magnitude > peak) peak = magnitude;
+    }
+    lv->dc = dc;
+
+    uint32_t rms = (count > 0) ? level_isqrt((uint32_t)(energy / count)) : 0;
+
+    // Porta com histerese, decidida contra o piso anterior ao bloco: o ataque de uma
+    // nota não chega a puxar o piso antes de abrir a porta
+    uint32_t threshold = lv->floor * LEVEL_OPEN_RATIO;
+    if (threshold < ((uint32_t)lv->min_level << FLOOR_SHIFT)) threshold = (uint32_t)lv->min_level << FLOOR_SHIFT;
+    uint32_t level = rms << FLOOR_SHIFT;
+    if (!lv->open && level >= threshold) lv->open = true;
+    else if (lv->open && level < threshold / 2) lv->open = false;
+
+    uint32_t tau_ms = (level < lv->floor) ? LEVEL_FALL_MS : lv->open ? LEVEL_RISE_OPEN_MS : LEVEL_RISE_MS;
+    level_track(lv, rms, count, tau_ms);
+
+    reading->dc = (uint16_t)((dc + (1 << (LEVEL_DC_SHIFT - 1))) >> LEVEL_DC_SHIFT);
+    reading->rms = (uint16_t)rms;
+    reading->peak = (uint16_t)peak;
+    reading->floor = (uint16_t)(lv->floor >> FLOOR_SHIFT);
+    reading->open = lv->open;
+    return lv->open;
+}
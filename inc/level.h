@@ -0,0 +1,52 @@
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Estatísticas do sinal, atualizadas numa única passada por bloco: nível DC do
+// microfone, RMS e pico do sinal sem DC, piso de ruído adaptativo e a porta que
+// decide se o bloco segue para o detector.
+//
+// O DC é uma média exponencial por amostra (passa-altas de ~0,16 Hz a 4 kHz), então o
+// bloco sai centrado em zero sem uma passada extra para a média; o primeiro bloco
+// fixa o nível inicial pela sua média. O RMS, ao contrário do pico a pico, quase não
+// muda com um clique isolado.
+//
+// O piso de ruído segue o RMS dos blocos: desce depressa (LEVEL_FALL_MS) e sobe
+// devagar (LEVEL_RISE_MS com a porta fechada, LEVEL_RISE_OPEN_MS com ela aberta, para
+// que uma nota longa não vire ruído). A porta abre quando o RMS passa de
+// max(min_level, LEVEL_OPEN_RATIO x piso) e só fecha abaixo da metade desse limiar.
+
+#define LEVEL_DC_SHIFT 12          // Média exponencial do DC de 4096 amostras (~1 s a 4 kHz)
+#define LEVEL_FALL_MS 100          // Constante de tempo do piso quando o RMS cai
+#define LEVEL_RISE_MS 2000         // ... quando sobe, com a porta fechada
+#define LEVEL_RISE_OPEN_MS 30000   // ... quando sobe, com a porta aberta
+#define LEVEL_OPEN_RATIO 4         // Abertura a 12 dB acima do piso; fechamento a 6 dB
+
+typedef struct {
+    uint32_t sample_rate;   // Taxa das amostras (Hz)
+    uint16_t min_level;     // RMS mínimo para abrir a porta (contagens do ADC)
+    bool started;           // O DC já foi fixado pelo primeiro bloco
+    int32_t dc;             // Nível DC (contagens do ADC, Q LEVEL_DC_SHIFT)
+    uint32_t floor;         // Piso de ruído (RMS, Q8)
+    bool open;              // Estado da porta
+} level_t;
+
+// Leitura de um bloco
+typedef struct {
+    uint16_t dc;            // Nível DC ao fim do bloco (contagens do ADC)
+    uint16_t rms;           // RMS do bloco sem DC
+    uint16_t peak;          // Maior |amostra - DC| do bloco
+    uint16_t floor;         // Piso de ruído após o bloco (RMS)
+    bool open;              // Porta aberta: o bloco tem som acima do piso
+} level_reading_t;
+
+void level_init(level_t *lv, uint32_t sample_rate, uint16_t min_level);
+
+// Processa amostras do ADC (12 bits) consecutivas às da chamada anterior, escrevendo
+// em `centered` as mesmas amostras sem DC. Retorna reading->open.
+bool level_process(level_t *lv, const uint16_t *samples, uint32_t count, int16_t *centered,
+                   level_reading_t *reading);
+
+#endif // LEVEL_H
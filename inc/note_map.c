@@ -0,0 +1,110 @@
+#include "note_map.h"
+
+const char *const note_map_names[12] = {
+    "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"
+};
+
+// 2^(k/12) em Q30 (k = 0..12)
+static const uint32_t semitone_up[13] = {
+    1073741824u, 1137589835u, 1205234447u, 1276901417u, 1352829926u, 1433273380u, 1518500250u,
+    1608794974u, 1704458901u, 1805811301u, 1913190429u, 2026954652u, 2147483648u
+};
+
+#define QUARTER_TONE_UP 1105204861      // 2^(1/24) em Q30: fronteira entre notas vizinhas
+#define LN_ONE (1 << 30)                // Série de ln(1+x) em Q30
+#define LN_HALF (1 << 29)
+#define LN_THIRD 357913941
+#define CENTS_PER_NEPER 113458155       // 1200 / ln(2) em Q16
+
+#define NOTE_COUNT (NOTE_MAP_MAX_MIDI - NOTE_MAP_MIN_MIDI + 1)
+
+static volatile fixed_t reference_a4 = NOTE_MAP_DEFAULT_A4;  // Lida também pelo núcleo 0
+static fixed_t note_freq[NOTE_COUNT];
+// boundary[j]: limite superior da nota NOTE_MAP_MIN_MIDI - 1 + j (j = 0 é o limite inferior de B0)
+static fixed_t boundary[NOTE_COUNT + 1];
+static bool table_ready = false;
+
+static inline int32_t mul_q30(int32_t a, int32_t b) {
+    return (int32_t)(((int64_t)a * b) >> 30);
+}
+
+// Frequência de uma nota em Q46 (Q16.16 x 2^30), sem arredondar
+static int64_t note_freq_q46(fixed_t a4, int midi) {
+    int n = midi - NOTE_MAP_A4_MIDI;
+    int octave = (n >= 0) ? n / 12 : -((11 - n) / 12);
+    int64_t f = (int64_t)a4 * semitone_up[n - 12 * octave];
+    return (octave >= 0) ? f << octave : f >> -octave;
+}
+
+void note_map_set_reference(fixed_t a4_hz) {
+    reference_a4 = a4_hz;
+
+    for (int midi = NOTE_MAP_MIN_MIDI - 1; midi <= NOTE_MAP_MAX_MIDI; midi++) {
+        int64_t f = note_freq_q46(a4_hz, midi);
+        int j = midi - NOTE_MAP_MIN_MIDI;
+        if (j >= 0) note_freq[j] = (fixed_t)((f + (1 << 29)) >> 30);
+        boundary[j + 1] = (fixed_t)((((f >> 30) * QUARTER_TONE_UP) + (1 << 29)) >> 30);
+    }
+    table_ready = true;
+}
+
+fixed_t note_map_get_reference(void) {
+    return reference_a4;
+}
+
+fixed_t note_map_frequency(uint8_t midi) {
+    if (!table_ready) note_map_set_reference(NOTE_MAP_DEFAULT_A4);
+    if (midi < NOTE_MAP_MIN_MIDI) midi = NOTE_MAP_MIN_MIDI;
+    if (midi > NOTE_MAP_MAX_MIDI) midi = NOTE_MAP_MAX_MIDI;
+    return note_freq[midi - NOTE_MAP_MIN_MIDI];
+}
+
+fixed_t note_map_frequency_at(fixed_t a4_hz, uint8_t midi) {
+    return (fixed_t)((note_freq_q46(a4_hz, midi) + (1 << 29)) >> 30);
+}
+
+bool note_map_lookup(fixed_t frequency, note_info_t *info) {
+    if (!table_ready) note_map_set_reference(NOTE_MAP_DEFAULT_A4);
+    if (frequency <= 0) return false;
+
+    // Quantas fronteiras ficam abaixo da frequência (busca binária em NOTE_COUNT + 1)
+    uint32_t lo = 0, hi = NOTE_COUNT + 1;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) >> 1;
+        if (frequency >= boundary[mid]) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == 0 || lo > NOTE_COUNT) return false;  // Abaixo de B0 ou acima de C7
+
+    uint32_t midi = NOTE_MAP_MIN_MIDI - 1 + lo;
+    fixed_t target = note_freq[lo - 1];
+
+    // cents = 1200 * log2(r), com r = f / alvo próximo de 1 (|x| < 3%)
+    int32_t x = (int32_t)((((int64_t)frequency << 30) / target) - LN_ONE);
+    int32_t t = LN_THIRD - (x >> 2);
+    t = LN_HALF - mul_q30(x, t);
+    t = LN_ONE - mul_q30(x, t);
+    int32_t ln = mul_q30(x, t);
+
+    info->midi = (uint8_t)midi;
+    info->pitch_class = (uint8_t)(midi % 12);
+    info->octave = (int8_t)(midi / 12 - 1);
+    info->cents = (fixed_t)(((int64_t)ln * CENTS_PER_NEPER) >> 30);
+    info->target_freq = target;
+    return true;
+}
+
+void note_map_note(uint8_t midi, note_info_t *info) {
+    info->midi = midi;
+    info->pitch_class = (uint8_t)(midi % 12);
+    info->octave = (int8_t)(midi / 12 - 1);
+    info->cents = 0;
+    info->target_freq = note_map_frequency_at(reference_a4, midi);  // Mesmo arredondamento da tabela
+}
+
+void note_map_format(const note_info_t *info, char *out) {
+    const char *name = note_map_names[info->pitch_class];
+    while (*name) *out++ = *name++;
+    *out++ = (char)('0' + info->octave);
+    *out = '\0';
+}
@@ -0,0 +1,56 @@
+#ifndef NOTE_MAP_H
+#define NOTE_MAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixed.h"
+
+// Mapeamento frequência -> nota cromática, em tempo constante e só com inteiros.
+//
+// A frequência (Q16.16) é comparada por busca binária com as fronteiras de meio
+// semitom entre as notas de B0 a C7, geradas para a referência A4 atual. O desvio
+// em cents sai de uma série curta de ln(1+x) em Q30 em torno da nota mais próxima
+// (|x| < 3%).
+//
+// A tabela pertence ao núcleo da análise: note_map_set_reference() a reescreve sem
+// trava, então note_map_lookup() e note_map_frequency() só podem ser chamadas nesse
+// núcleo. note_map_note() e note_map_frequency_at() não leem a tabela e servem à tela.
+
+#define NOTE_MAP_MIN_MIDI 23    // B0 (~30,9 Hz), corda mais grave do baixo de 5 cordas
+#define NOTE_MAP_MAX_MIDI 96    // C7 (~2093 Hz)
+#define NOTE_MAP_A4_MIDI 69     // Número MIDI de A4
+#define NOTE_MAP_DEFAULT_A4 FIXED_FROM_INT(440)
+
+// Nota cromática mais próxima de uma frequência
+typedef struct {
+    uint8_t midi;         // Número MIDI (A4 = 69)
+    uint8_t pitch_class;  // 0 = C, 1 = C#, ..., 11 = B
+    int8_t octave;        // Oitava em notação científica (A4 = 4)
+    fixed_t cents;        // Desvio em relação à nota (-50 a +50, Q16.16)
+    fixed_t target_freq;  // Frequência exata da nota com a referência atual (Hz, Q16.16)
+} note_info_t;
+
+extern const char *const note_map_names[12];  // "C", "C#", ..., "B"
+
+// Define a referência de afinação (A4) e recalcula a tabela de notas
+void note_map_set_reference(fixed_t a4_hz);
+fixed_t note_map_get_reference(void);
+
+// Nota mais próxima de uma frequência; falso fora de B0..C7
+bool note_map_lookup(fixed_t frequency, note_info_t *info);
+
+// Frequência de uma nota MIDI (NOTE_MAP_MIN_MIDI..NOTE_MAP_MAX_MIDI) por consulta à tabela
+fixed_t note_map_frequency(uint8_t midi);
+
+// Frequência de uma nota MIDI com outra referência, sem tocar na tabela (pode ser
+// chamada de um núcleo enquanto o outro usa note_map_lookup)
+fixed_t note_map_frequency_at(fixed_t a4_hz, uint8_t midi);
+
+// Preenche a nota de um número MIDI (desvio 0), para alvos escolhidos pelo chamador.
+// A frequência vem da referência atual (uma palavra), sem tocar na tabela.
+void note_map_note(uint8_t midi, note_info_t *info);
+
+// Nome com oitava, ex.: "A#2" (buffer de pelo menos 5 bytes)
+void note_map_format(const note_info_t *info, char *out);
+
+#endif // NOTE_MAP_H
@@ -57,26 +57,39 @@ const uint8_t notes[7][25] = {
       1, 1, 1, 1, 0 }
 };
 
+// Tamanho dos desenhos das notas; em matrizes maiores eles ficam centralizados
+#define NOTE_GLYPH_SIZE 5
+#define NOTE_ROW_OFFSET ((WS2812_ROWS - NOTE_GLYPH_SIZE) / 2)
+#define NOTE_COL_OFFSET ((WS2812_COLS - NOTE_GLYPH_SIZE) / 2)
+
+_Static_assert(WS2812_ROWS >= NOTE_GLYPH_SIZE && WS2812_COLS >= NOTE_GLYPH_SIZE,
+               "a matriz precisa de ao menos 5x5 LEDs");
+
 // Função para retornar a cor de um LED aceso
 static inline LedConfig ledOn() {
-    LedConfig color = {0.3, 0.3, 0.3}; // Branco (RGB: 0.3, 0.3, 0.3)
+    LedConfig color = {76, 76, 76}; // Branco (30% de brilho)
+    return color;
+}
+
+// Função para retornar a cor de um LED aceso em uma nota sustenida
+static inline LedConfig ledSharp() {
+    LedConfig color = {0, 0, 76}; // Azul (30% de brilho)
     return color;
 }
 
 // Função para retornar a cor de um LED apagado
 static inline LedConfig ledOff() {
-    LedConfig color = {0.0, 0.0, 0.0}; // Preto (RGB: 0.0, 0.0, 0.0)
+    LedConfig color = {0, 0, 0}; // Preto
     return color;
 }
 
 // Função para converter uma matriz de nota em uma matriz de cores
 void convertNoteToLedMatrix(const uint8_t note[25], LedMatrix ledMatrix) {
-    for (int i = 0; i < 5; i++) {
-        for (int j = 0; j < 5; j++) {
-            if (note[i * 5 + j] == 1) {
-                ledMatrix[i][j] = ledOn(); // LED aceso
-            } else {
-                ledMatrix[i][j] = ledOff(); // LED apagado
+    clearLedMatrix(ledMatrix);
+    for (int i = 0; i < NOTE_GLYPH_SIZE; i++) {
+        for (int j = 0; j < NOTE_GLYPH_SIZE; j++) {
+            if (note[i * NOTE_GLYPH_SIZE + j] == 1) {
+                ledMatrix[i + NOTE_ROW_OFFSET][j + NOTE_COL_OFFSET] = ledOn(); // LED aceso
             }
         }
     }
@@ -89,4 +102,26 @@ void getNote(uint8_t noteIndex, LedMatrix ledMatrix) {
     }
 }
 
+// Nota natural usada para desenhar cada classe de altura (C, C#, D, ..., B)
+const uint8_t naturalOfPitchClass[12] = {0, 0, 1, 1, 2, 3, 3, 4, 4, 5, 5, 6};
+
+// Função para obter a matriz de cores de uma nota cromática (0 = C ... 11 = B).
+// Sustenidos usam a letra da nota natural abaixo, acesa em azul.
+void getChromaticNote(uint8_t pitchClass, LedMatrix ledMatrix) {
+    if (pitchClass >= 12) return;
+
+    uint8_t natural = naturalOfPitchClass[pitchClass];
+    getNote(natural, ledMatrix);
+
+    if (pitchClass > 0 && naturalOfPitchClass[pitchClass - 1] == natural) {
+        for (int i = 0; i < NOTE_GLYPH_SIZE; i++) {
+            for (int j = 0; j < NOTE_GLYPH_SIZE; j++) {
+                if (notes[natural][i * NOTE_GLYPH_SIZE + j] == 1) {
+                    ledMatrix[i + NOTE_ROW_OFFSET][j + NOTE_COL_OFFSET] = ledSharp();
+                }
+            }
+        }
+    }
+}
+
 #endif // NOTES_H
\ No newline at end of file
@@ -0,0 +1,299 @@
+#include "pitch.h"
+
+static int32_t nsdf[PITCH_MAX_LAG + 2];     // NSDF em Q15, usada para escolher o pico
+
+// Produto interno com desenrolamento de 4: o laço interno não tem dependências
+// entre iterações além do acumulador, então o compilador pode vetorizá-lo.
+static int64_t pitch_dot(const int16_t *a, const int16_t *b, uint32_t n) {
+    int32_t acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+    int64_t total = 0;
+    uint32_t i = 0;
+
+    // Cada parcial acumula no máximo 64 produtos antes de ser descarregado: as amostras
+    // sem DC vão até +-4095 (enquanto o DC de level.c se acomoda), e 64 x 4095^2 < 2^31
+    while (i + 4 <= n) {
+        uint32_t end = i + 4 * 64;
+        if (end > n) end = n & ~3u;
+        for (; i < end; i += 4) {
+            acc0 += a[i] * b[i];
+            acc1 += a[i + 1] * b[i + 1];
+            acc2 += a[i + 2] * b[i + 2];
+            acc3 += a[i + 3] * b[i + 3];
+        }
+        total += (int64_t)acc0 + acc1 + acc2 + acc3;
+        acc0 = acc1 = acc2 = acc3 = 0;
+    }
+    for (; i < n; i++) {
+        total += a[i] * b[i];
+    }
+    return total;
+}
+
+// NSDF 2r/m em Q15 para a escolha de picos. m é reduzido a 15 bits, então a divisão é
+// de 32 bits (divisor em hardware no RP2040); como 2|r| <= m, o numerador cabe em 31 bits.
+static int32_t nsdf_q15(int64_t r, int64_t m) {
+    if (m <= 0) return 0;
+    int bits = 64 - __builtin_clzll((uint64_t)m);
+    int shift = bits > 15 ? bits - 15 : 0;
+    int32_t mm = (int32_t)(m >> shift);
+    int32_t rr = (int32_t)((2 * r) >> shift);
+    return (rr << 15) / mm;
+}
+
+// NSDF em Q30 para os três pontos da interpolação (divisão de 64 bits, só 3 por quadro)
+static int32_t nsdf_q30(int64_t r, int64_t m) {
+    if (m <= 0) return 0;
+    int bits = 64 - __builtin_clzll((uint64_t)m);
+    int shift = bits > 32 ? bits - 32 : 0;
+    int64_t mm = m >> shift;
+    int64_t rr = (2 * r) >> shift;
+    return (int32_t)((rr << 30) / mm);
+}
+
+// NSDF em Q30 nos atrasos tau0, tau0 + 1 e tau0 + 2, dados r nesses atrasos e m(tau0);
+// m dos atrasos seguintes sai de m(tau0) sem percorrer a janela de novo
+static void pitch_points(const int16_t *x, uint32_t n, uint32_t tau0, int64_t m, const int64_t r[3],
+                         int32_t v[3]) {
+    for (uint32_t j = 0; j < 3; j++) {
+        uint32_t tau = tau0 + j;
+        v[j] = nsdf_q30(r[j], m);
+        m -= x[n - 1 - tau] * x[n - 1 - tau] + x[tau] * x[tau];
+    }
+}
+
+// Escolha de picos (McLeod) sobre nsdf[0..max_lag - first], onde nsdf[k] é o
+// valor no atraso k + first: o maior máximo local de cada região positiva é um
+// pico-chave; o primeiro acima de PITCH_KEY_THRESHOLD do maior vence.
+// Retorna o índice k escolhido, ou 0 se não houver pico.
+static uint32_t pitch_pick(uint32_t first, uint32_t max_lag) {
+    uint32_t last = max_lag - first;
+    uint32_t key_lag[32];
+    uint32_t keys = 0;
+    int32_t highest = 0;
+    uint32_t region_best = 0;
+
+    for (uint32_t k = 1; k < last; k++) {
+        int32_t v = nsdf[k];
+        if (v > 0) {
+            if (v > nsdf[k - 1] && v >= nsdf[k + 1]) {
+                if (region_best == 0 || v > nsdf[region_best]) region_best = k;
+            }
+        }
+        if ((v <= 0 || k == last - 1) && region_best != 0) {
+            if (keys < 32) key_lag[keys++] = region_best;
+            if (nsdf[region_best] > highest) highest = nsdf[region_best];
+            region_best = 0;
+        }
+    }
+    if (keys == 0) return 0;
+
+    int32_t threshold = (PITCH_KEY_THRESHOLD * highest) >> 15;
+    for (uint32_t i = 0; i < keys; i++) {
+        if (nsdf[key_lag[i]] >= threshold) return key_lag[i];
+    }
+    return key_lag[0];
+}
+
+// Interpolação parabólica (valores da NSDF em Q30 nos atrasos tau - 1, tau e tau + 1)
+// para obter o período com resolução fracionária, a clareza e a frequência
+static bool pitch_interpolate(int32_t a, int32_t b, int32_t c, uint32_t tau, uint32_t sample_rate,
+                              pitch_result_t *result) {
+    int64_t denom = (int64_t)a - 2 * (int64_t)b + c;
+    int32_t delta = 0;  // Deslocamento do vértice em Q16, limitado a meio atraso
+    if (denom != 0) {
+        int64_t d = (((int64_t)a - c) << 15) / denom;
+        if (d > FIXED_ONE / 2) d = FIXED_ONE / 2;
+        if (d < -FIXED_ONE / 2) d = -FIXED_ONE / 2;
+        delta = (int32_t)d;
+    }
+    int64_t period = ((int64_t)tau << FIXED_SHIFT) + delta;
+
+    int64_t clarity = b - ((((int64_t)a - c) * delta) >> 18);  // b - (a - c) * delta / 4
+    clarity >>= 15;
+    if (clarity > Q15_ONE) clarity = Q15_ONE;
+    if (clarity < 0) clarity = 0;
+
+    result->clarity = (q15_t)clarity;
+    result->frequency = (fixed_t)(((int64_t)sample_rate << 32) / period);
+    return result->clarity >= PITCH_MIN_CLARITY;
+}
+
+bool pitch_detect(const int16_t *centered, uint32_t buffer_size, uint32_t sample_rate,
+                  uint32_t min_freq, uint32_t max_freq, pitch_result_t *result) {
+    result->frequency = 0;
+    result->clarity = 0;
+
+    if (buffer_size > PITCH_MAX_WINDOW) buffer_size = PITCH_MAX_WINDOW;
+
+    // Faixa de atrasos limitada pela faixa de frequências e pela metade da janela
+    uint32_t min_lag = sample_rate / max_freq;
+    uint32_t max_lag = sample_rate / min_freq + 1;
+    if (min_lag < 2) min_lag = 2;
+    if (max_lag > buffer_size / 2) max_lag = buffer_size / 2;
+    if (max_lag > PITCH_MAX_LAG) max_lag = PITCH_MAX_LAG;
+    if (min_lag + 2 > max_lag) return false;
+
+    // m(tau) = soma de x[i]^2 + x[i+tau]^2 na região sobreposta, atualizada a cada atraso
+    uint32_t first = min_lag - 1;
+    int64_t m = 0;
+    for (uint32_t i = 0; i < buffer_size - first; i++) {
+        m += centered[i] * centered[i] + centered[i + first] * centered[i + first];
+    }
+
+    for (uint32_t tau = first; tau <= max_lag + 1 && tau < buffer_size; tau++) {
+        int64_t r = pitch_dot(centered, centered + tau, buffer_size - tau);
+        nsdf[tau - first] = nsdf_q15(r, m);
+
+        // Remove os termos que saem da sobreposição no próximo atraso
+        int32_t tail = centered[buffer_size - 1 - tau];
+        int32_t head = centered[tau];
+        m -= tail * tail + head * head;
+    }
+
+    uint32_t k = pitch_pick(first, max_lag);
+    if (k == 0) return false;
+
+    // Recalcula os três pontos da interpolação com precisão total
+    uint32_t tau0 = k + first - 1;
+    int64_t r[3];
+    m = 0;
+    for (uint32_t i = 0; i < buffer_size - tau0; i++) {
+        m += centered[i] * centered[i] + centered[i + tau0] * centered[i + tau0];
+    }
+    for (uint32_t j = 0; j < 3; j++) {
+        r[j] = pitch_dot(centered, centered + tau0 + j, buffer_size - tau0 - j);
+    }
+    int32_t v[3];
+    pitch_points(centered, buffer_size, tau0, m, r, v);
+    return pitch_interpolate(v[0], v[1], v[2], k + first, sample_rate, result);
+}
+
+// ---------------------------------------------------------------------------
+// Análise contínua
+
+#define RING_MASK (PITCH_STREAM_RING - 1)
+
+// Produto interno curto (um salto) em 32 bits: PITCH_STREAM_MAX_HOP x 4095^2 < 2^31
+static int32_t pitch_dot_hop(const int16_t *a, const int16_t *b, uint32_t n) {
+    int32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        acc += a[i] * b[i];
+    }
+    return acc;
+}
+
+void pitch_stream_init(pitch_stream_t *ps, uint32_t window, uint32_t hop, uint32_t sample_rate,
+                       uint32_t min_freq, uint32_t max_freq) {
+    if (window > PITCH_STREAM_MAX_WINDOW) window = PITCH_STREAM_MAX_WINDOW;
+    if (hop > PITCH_STREAM_MAX_HOP) hop = PITCH_STREAM_MAX_HOP;
+    if (hop > window / 4) hop = window / 4;
+    if (hop == 0) hop = 1;
+
+    ps->window = window;
+    ps->hop = hop;
+    ps->sample_rate = sample_rate;
+
+    // Mesma faixa de atrasos de pitch_detect(); como tau <= janela / 2 + 1 < janela - salto,
+    // os pares que entram e os que saem a cada salto nunca se sobrepõem
+    uint32_t min_lag = sample_rate / max_freq;
+    uint32_t max_lag = sample_rate / min_freq + 1;
+    if (min_lag < 2) min_lag = 2;
+    if (max_lag > window / 2) max_lag = window / 2;
+    if (max_lag > PITCH_MAX_LAG) max_lag = PITCH_MAX_LAG;
+    ps->first = min_lag - 1;
+    ps->max_lag = max_lag;
+
+    ps->head = 0;
+    ps->pending = 0;
+    ps->energy = 0;
+    for (uint32_t i = 0; i < PITCH_MAX_LAG + 2; i++) ps->r[i] = 0;
+    for (uint32_t i = 0; i < 2 * PITCH_STREAM_RING; i++) ps->ring[i] = 0;
+}
+
+// Desliza a janela um salto: as amostras [head - hop, head) acabaram de entrar
+static void pitch_stream_hop(pitch_stream_t *ps) {
+    const uint32_t window = ps->window, hop = ps->hop;
+    const uint32_t last_tau = ps->max_lag + 1;
+
+    // new_x[j] é a j-ésima amostra que entrou; old_x[j], a j-ésima que saiu.
+    // Usando a cópia espelhada, [old_x, new_x + hop) é contíguo.
+    uint32_t index = (ps->head - hop) & RING_MASK;
+    if (index < window) index += PITCH_STREAM_RING;
+    const int16_t *new_x = &ps->ring[index];
+    const int16_t *old_x = new_x - window;
+
+    for (uint32_t tau = ps->first; tau <= last_tau; tau++) {
+        // Pares (i, i + tau) que entram: i + tau entre as novas amostras.
+        // Pares que saem: i entre as amostras descartadas.
+        int32_t added = pitch_dot_hop(new_x - tau, new_x, hop);
+        int32_t removed = pitch_dot_hop(old_x, old_x + tau, hop);
+        ps->r[tau] += (int64_t)added - removed;  // Cada parcela usa quase os 32 bits
+    }
+
+    for (uint32_t j = 0; j < hop; j++) {
+        ps->energy += new_x[j] * new_x[j] - old_x[j] * old_x[j];
+    }
+}
+
+// NSDF da janela atual a partir de r(tau) e da energia, seguida da escolha de picos.
+// m(tau) = 2E - (soma de x^2 nas primeiras tau amostras) - (nas últimas tau amostras)
+static bool pitch_stream_estimate(pitch_stream_t *ps, pitch_result_t *result) {
+    const uint32_t window = ps->window, first = ps->first;
+    const int16_t *x = &ps->ring[(ps->head - window) & RING_MASK];
+
+    int64_t lead = 0, trail = 0;
+    for (uint32_t i = 0; i < first; i++) {
+        lead += x[i] * x[i];
+        trail += x[window - 1 - i] * x[window - 1 - i];
+    }
+
+    for (uint32_t tau = first; tau <= ps->max_lag + 1; tau++) {
+        int64_t m = 2 * ps->energy - lead - trail;
+        nsdf[tau - first] = nsdf_q15(ps->r[tau], m);
+        lead += x[tau] * x[tau];
+        trail += x[window - 1 - tau] * x[window - 1 - tau];
+    }
+
+    result->frequency = 0;
+    result->clarity = 0;
+    if (first + 3 > ps->max_lag) return false;
+
+    uint32_t k = pitch_pick(first, ps->max_lag);
+    if (k == 0) return false;
+
+    uint32_t tau0 = k + first - 1;
+    int64_t edge = 0;
+    for (uint32_t i = 0; i < tau0; i++) {
+        edge += x[i] * x[i] + x[window - 1 - i] * x[window - 1 - i];
+    }
+    int32_t v[3];
+    pitch_points(x, window, tau0, 2 * ps->energy - edge, &ps->r[tau0], v);
+    return pitch_interpolate(v[0], v[1], v[2], k + first, ps->sample_rate, result);
+}
+
+bool pitch_stream_push(pitch_stream_t *ps, const int16_t *samples, uint32_t count, bool estimate,
+                       pitch_result_t *result) {
+    bool hopped = false;
+    result->frequency = 0;
+    result->clarity = 0;
+
+    for (uint32_t n = 0; n < count; n++) {
+        int16_t v = samples[n];
+        uint32_t slot = ps->head & RING_MASK;
+        ps->ring[slot] = v;
+        ps->ring[slot + PITCH_STREAM_RING] = v;
+        ps->head++;
+
+        if (++ps->pending < ps->hop) continue;
+
+        pitch_stream_hop(ps);
+        ps->pending = 0;
+
+        // Estima só no último salto do lote: os anteriores apenas atualizam as somas
+        if (ps->head >= ps->window && count - n <= ps->hop) {
+            hopped = true;
+            if (estimate) pitch_stream_estimate(ps, result);
+        }
+    }
+    return hopped;
+}
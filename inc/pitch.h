@@ -0,0 +1,68 @@
+#ifndef PITCH_H
+#define PITCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixed.h"
+
+// Limites do detector McLeod (MPM / NSDF)
+#define PITCH_MAX_WINDOW 2048    // Maior bloco aceito por pitch_detect()
+#define PITCH_MAX_LAG 1024       // Maior atraso avaliado (limita o custo por quadro)
+#define PITCH_KEY_THRESHOLD Q15_CONST(0.9) // Fração do maior pico usada para escolher o período
+#define PITCH_MIN_CLARITY Q15_CONST(0.6)   // Clareza mínima para aceitar uma estimativa
+
+// Resultado de uma estimativa de altura
+typedef struct {
+    fixed_t frequency;  // Frequência fundamental (Hz, Q16.16), 0 se não houver período claro
+    q15_t clarity;      // Valor do pico da NSDF (Q15, 0..1): confiança na estimativa
+} pitch_result_t;
+
+// Estima a frequência fundamental de um bloco de amostras sem DC (ADC de 12 bits
+// centrado em zero, até +-4095; ver level.h).
+// Apenas os atrasos correspondentes a [min_freq, max_freq] (Hz) são avaliados,
+// então o custo por quadro é fixo: (max_lag - min_lag) produtos internos.
+// Só inteiros: a NSDF usada na escolha do pico é Q15, e os três pontos da
+// interpolação parabólica são recalculados em Q30.
+bool pitch_detect(const int16_t *centered, uint32_t buffer_size, uint32_t sample_rate,
+                  uint32_t min_freq, uint32_t max_freq, pitch_result_t *result);
+
+// ---------------------------------------------------------------------------
+// Análise contínua com janelas sobrepostas
+//
+// As amostras entram num buffer circular espelhado (cada amostra é gravada em duas
+// posições, então qualquer janela é contígua). A cada salto de `hop` amostras, os
+// produtos r(tau) da janela são atualizados em vez de recalculados: somam-se os
+// pares que entram com as novas amostras e subtraem-se os que saem com as antigas.
+// O custo é 2 x hop x atrasos por salto, ou seja, duas multiplicações por amostra e
+// por atraso, qualquer que seja o salto. Os somatórios são inteiros e exatos.
+
+#define PITCH_STREAM_MAX_WINDOW 1024  // Maior janela da análise contínua
+#define PITCH_STREAM_MAX_HOP 128      // Maior salto (limita os acumuladores de 32 bits)
+#define PITCH_STREAM_RING 2048        // Capacidade do buffer circular (potência de 2)
+
+typedef struct {
+    uint32_t window;        // Amostras por janela
+    uint32_t hop;           // Amostras entre estimativas
+    uint32_t sample_rate;   // Taxa de amostragem (Hz)
+    uint32_t first;         // Primeiro atraso avaliado (min_lag - 1)
+    uint32_t max_lag;       // Maior atraso procurado
+    uint32_t head;          // Total de amostras recebidas
+    uint32_t pending;       // Amostras recebidas desde o último salto
+    int64_t energy;         // Soma de x^2 na janela
+    int64_t r[PITCH_MAX_LAG + 2];               // Produtos r(tau) da janela
+    int16_t ring[2 * PITCH_STREAM_RING];        // Amostras (sem DC), espelhadas
+} pitch_stream_t;
+
+// Configura a análise. Janela e salto são limitados a PITCH_STREAM_MAX_WINDOW e
+// PITCH_STREAM_MAX_HOP; o salto também fica limitado a um quarto da janela.
+void pitch_stream_init(pitch_stream_t *ps, uint32_t window, uint32_t hop, uint32_t sample_rate,
+                       uint32_t min_freq, uint32_t max_freq);
+
+// Acrescenta amostras sem DC (ver level.h). Retorna true se ao menos um salto
+// terminou com a janela já cheia; *result recebe a estimativa do salto mais recente.
+// Com estimate = false (bloco abaixo da porta de ruído), só as somas da janela são
+// atualizadas e *result fica zerado.
+bool pitch_stream_push(pitch_stream_t *ps, const int16_t *samples, uint32_t count, bool estimate,
+                       pitch_result_t *result);
+
+#endif // PITCH_H
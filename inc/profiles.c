@@ -0,0 +1,118 @@
+#include "profiles.h"
+
+// Faixas: de ~4 semitons abaixo da corda mais grave a ~5 semitons acima da mais aguda
+static const tuning_profile_t profiles[PROFILE_CUSTOM] = {
+    [PROFILE_CHROMATIC] = {"Cromatico",      0, {0},                      40, 1000},
+    [PROFILE_GUITAR]    = {"Violao padrao",  6, {40, 45, 50, 55, 59, 64}, 65, 440},
+    [PROFILE_DROP_D]    = {"Violao drop D",  6, {38, 45, 50, 55, 59, 64}, 58, 440},
+    [PROFILE_BASS4]     = {"Baixo 4 cordas", 4, {28, 33, 38, 43},         33, 131},
+    [PROFILE_BASS5]     = {"Baixo 5 cordas", 5, {23, 28, 33, 38, 43},     25, 131},
+    [PROFILE_UKULELE]   = {"Ukulele",        4, {67, 60, 64, 69},         208, 587},
+    [PROFILE_VIOLIN]    = {"Violino",        4, {55, 62, 69, 76},         155, 880},
+    [PROFILE_CELLO]     = {"Violoncelo",     4, {36, 43, 50, 57},         52, 294},
+};
+
+// Até o comando 'c' do console (aplicado por profile_set_custom()), igual ao violão padrão
+static tuning_profile_t custom = {"Personalizado", 6, {40, 45, 50, 55, 59, 64}, 65, 440};
+
+const tuning_profile_t *profile_get(uint8_t id) {
+    if (id == PROFILE_CUSTOM) return &custom;
+    if (id >= PROFILE_COUNT) id = PROFILE_CHROMATIC;
+    return &profiles[id];
+}
+
+void profile_set_custom(const uint8_t *midi, uint8_t strings, uint16_t min_freq, uint16_t max_freq) {
+    if (strings > PROFILE_MAX_STRINGS) strings = PROFILE_MAX_STRINGS;
+    custom.strings = strings;
+    for (uint8_t i = 0; i < strings; i++) custom.midi[i] = midi[i];
+    custom.min_freq = min_freq;
+    custom.max_freq = max_freq;
+}
+
+// Nota em texto, ex.: "E2", "F#3" ou "Bb1"; avança *text. Falso fora de B0..C7.
+static bool parse_note(const char **text, uint8_t *midi) {
+    static const uint8_t letter_class[7] = {9, 11, 0, 2, 4, 5, 7};  // A a G
+    const char *p = *text;
+    char letter = (*p >= 'a' && *p <= 'g') ? (char)(*p - 'a' + 'A') : *p;
+    if (letter < 'A' || letter > 'G') return false;
+    int32_t value = letter_class[letter - 'A'];
+    p++;
+    if (*p == '#') {
+        value++;
+        p++;
+    } else if (*p == 'b') {
+        value--;
+        p++;
+    }
+    if (*p < '0' || *p > '9') return false;
+    value += 12 * (*p++ - '0' + 1);
+    if (value < NOTE_MAP_MIN_MIDI || value > NOTE_MAP_MAX_MIDI) return false;
+    *midi = (uint8_t)value;
+    *text = p;
+    return true;
+}
+
+// Frequência de uma nota MIDI arredondada para Hz inteiros (referência de 440 Hz)
+static uint16_t round_hz(int32_t midi) {
+    if (midi < 0) midi = 0;
+    return (uint16_t)fixed_round(note_map_frequency_at(FIXED_FROM_INT(440), (uint8_t)midi));
+}
+
+bool profile_parse_custom(const char *text, tuning_profile_t *out) {
+    const tuning_profile_t *chromatic = &profiles[PROFILE_CHROMATIC];
+    *out = custom;
+    out->strings = 0;
+    uint8_t lowest = NOTE_MAP_MAX_MIDI, highest = NOTE_MAP_MIN_MIDI;
+    for (;;) {
+        while (*text == ' ' || *text == ',') text++;
+        if (*text == '\0') break;
+        uint8_t midi;
+        if (out->strings == PROFILE_MAX_STRINGS || !parse_note(&text, &midi)) return false;
+        if (*text != '\0' && *text != ' ' && *text != ',') return false;
+        out->midi[out->strings++] = midi;
+        if (midi < lowest) lowest = midi;
+        if (midi > highest) highest = midi;
+    }
+
+    if (out->strings == 0) {
+        out->min_freq = chromatic->min_freq;
+        out->max_freq = chromatic->max_freq;
+    } else {
+        // Mesma margem dos perfis fixos; acima do cromático o detector não procura
+        out->min_freq = round_hz((int32_t)lowest - 4);
+        out->max_freq = round_hz((int32_t)highest + 5);
+        if (out->max_freq > chromatic->max_freq) out->max_freq = chromatic->max_freq;
+        if (out->min_freq >= out->max_freq) return false;
+    }
+    return true;
+}
+
+uint32_t profile_window(const tuning_profile_t *profile, uint32_t sample_rate, uint32_t max_window) {
+    uint32_t longest = PROFILE_PERIODS * (sample_rate / profile->min_freq + 1);
+    uint32_t window = PROFILE_MIN_WINDOW;
+    while (window < longest && window < max_window) window <<= 1;
+    return (window > max_window) ? max_window : window;
+}
+
+bool profile_closest_note(const tuning_profile_t *profile, fixed_t frequency, note_info_t *note) {
+    note_info_t chromatic;
+    if (!note_map_lookup(frequency, &chromatic)) return false;
+    if (profile->strings == 0) {
+        *note = chromatic;
+        return true;
+    }
+
+    // Desvio em relação a cada corda: semitons inteiros da nota cromática mais os cents
+    uint8_t best = 0;
+    fixed_t best_cents = 0;
+    for (uint8_t i = 0; i < profile->strings; i++) {
+        fixed_t cents = FIXED_FROM_INT(100 * ((int32_t)chromatic.midi - profile->midi[i])) + chromatic.cents;
+        if (i == 0 || fixed_abs(cents) < fixed_abs(best_cents)) {
+            best = i;
+            best_cents = cents;
+        }
+    }
+    note_map_note(profile->midi[best], note);
+    note->cents = best_cents;
+    return true;
+}
@@ -0,0 +1,61 @@
+#ifndef PROFILES_H
+#define PROFILES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "note_map.h"
+
+// Perfis de instrumento e afinação.
+//
+// Cada perfil traz as notas das cordas soltas e a faixa de frequências esperada.
+// A faixa limita os atrasos avaliados pelo detector (menos produtos por quadro e
+// sem saltos de oitava para fora do instrumento) e define o tamanho da janela
+// analisada; as cordas passam a ser os únicos alvos de get_closest_note() e as
+// cordas conferidas no modo Cordas.
+
+#define PROFILE_MAX_STRINGS 6
+#define PROFILE_MIN_WINDOW 256   // Menor janela (potência de 2, menor FFT suportada)
+#define PROFILE_PERIODS 3        // Períodos da nota mais grave que cabem na janela
+
+typedef enum {
+    PROFILE_CHROMATIC,      // Qualquer nota de 40 a 1000 Hz (comportamento original)
+    PROFILE_GUITAR,         // Violão, afinação padrão (E A D G B E)
+    PROFILE_DROP_D,         // Violão drop D (D A D G B E)
+    PROFILE_BASS4,          // Baixo de 4 cordas (E A D G)
+    PROFILE_BASS5,          // Baixo de 5 cordas (B E A D G)
+    PROFILE_UKULELE,        // Ukulele (G C E A, G reentrante)
+    PROFILE_VIOLIN,         // Violino (G D A E)
+    PROFILE_CELLO,          // Violoncelo (C G D A)
+    PROFILE_CUSTOM,         // Definido pelo console ('c' seguido das cordas)
+    PROFILE_COUNT
+} profile_id_t;
+
+typedef struct {
+    const char *name;                   // Nome exibido no OLED (até 16 caracteres)
+    uint8_t strings;                    // Número de cordas (0 = cromático)
+    uint8_t midi[PROFILE_MAX_STRINGS];  // Cordas soltas, na ordem do instrumento
+    uint16_t min_freq;                  // Menor frequência procurada (Hz)
+    uint16_t max_freq;                  // Maior frequência procurada (Hz)
+} tuning_profile_t;
+
+// Perfil pelo identificador (PROFILE_CHROMATIC se id for inválido)
+const tuning_profile_t *profile_get(uint8_t id);
+
+// Define o perfil personalizado (strings <= PROFILE_MAX_STRINGS; 0 = cromático)
+void profile_set_custom(const uint8_t *midi, uint8_t strings, uint16_t min_freq, uint16_t max_freq);
+
+// Monta um perfil personalizado a partir das cordas em texto, ex.: "E2 A2 D3 G3 B3 E4"
+// (sustenido com '#', bemol com 'b'). A faixa vai de 4 semitons abaixo da corda mais
+// grave a 5 acima da mais aguda, como nos perfis fixos; sem cordas, fica cromático.
+// Falso se alguma nota for inválida ou se houver mais de PROFILE_MAX_STRINGS cordas.
+bool profile_parse_custom(const char *text, tuning_profile_t *out);
+
+// Janela analisada: a menor potência de 2 que cabe PROFILE_PERIODS períodos da
+// menor frequência do perfil, entre PROFILE_MIN_WINDOW e max_window
+uint32_t profile_window(const tuning_profile_t *profile, uint32_t sample_rate, uint32_t max_window);
+
+// Corda do perfil mais próxima da frequência e o desvio em relação a ela (pode passar
+// de +-50 cents); num perfil cromático, a nota cromática mais próxima. Falso fora de B0..C7.
+bool profile_closest_note(const tuning_profile_t *profile, fixed_t frequency, note_info_t *note);
+
+#endif // PROFILES_H
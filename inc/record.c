@@ -0,0 +1,136 @@
+#include "record.h"
+#include <string.h>
+
+static inline void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_u32(uint8_t *p, uint32_t v) {
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static inline uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t get_u32(const uint8_t *p) {
+    return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+// Fletcher-16: duas somas por byte, barato o bastante para o núcleo da análise
+static uint16_t fletcher16(const uint8_t *data, size_t len) {
+    uint32_t a = 0, b = 0;
+    while (len > 0) {
+        size_t n = (len > 360) ? 360 : len;  // Sem estouro de 32 bits antes da redução
+        len -= n;
+        while (n-- > 0) {
+            a += *data++;
+            b += a;
+        }
+        a %= 255;
+        b %= 255;
+    }
+    return (uint16_t)((b << 8) | a);
+}
+
+size_t record_pack(const uint16_t *samples, uint16_t count, uint32_t seq, uint32_t sample_rate, uint8_t *out) {
+    if (count > RECORD_MAX_SAMPLES) count = RECORD_MAX_SAMPLES;
+
+    memcpy(out, RECORD_MAGIC, 4);
+    out[4] = RECORD_VERSION;
+    out[5] = RECORD_BITS;
+    put_u16(out + 6, count);
+    put_u32(out + 8, seq);
+    put_u32(out + 12, sample_rate);
+
+    uint8_t *p = out + RECORD_HEADER_SIZE;
+    uint32_t i = 0;
+    for (; i + 1 < count; i += 2) {
+        uint16_t a0 = samples[i] & 0x0FFF, a1 = samples[i + 1] & 0x0FFF;
+        p[0] = (uint8_t)a0;
+        p[1] = (uint8_t)((a0 >> 8) | (a1 << 4));
+        p[2] = (uint8_t)(a1 >> 4);
+        p += 3;
+    }
+    if (i < count) {
+        put_u16(p, samples[i] & 0x0FFF);
+        p += 2;
+    }
+
+    size_t size = (size_t)(p - out);
+    put_u16(p, fletcher16(out, size));
+    return size + 2;
+}
+
+int record_unpack(const uint8_t *data, size_t len, record_header_t *header, uint16_t *samples) {
+    // A marca é conferida byte a byte, para rejeitar cedo um início falso
+    for (size_t k = 0; k < 4 && k < len; k++) {
+        if (data[k] != (uint8_t)RECORD_MAGIC[k]) return -1;
+    }
+    if (len < RECORD_HEADER_SIZE) return 0;
+    if (data[4] != RECORD_VERSION || data[5] != RECORD_BITS) return -1;
+
+    uint16_t count = get_u16(data + 6);
+    if (count > RECORD_MAX_SAMPLES) return -1;
+    size_t size = RECORD_FRAME_SIZE(count);
+    if (len < size) return 0;
+    if (fletcher16(data, size - 2) != get_u16(data + size - 2)) return -1;
+
+    header->count = count;
+    header->seq = get_u32(data + 8);
+    header->sample_rate = get_u32(data + 12);
+
+    const uint8_t *p = data + RECORD_HEADER_SIZE;
+    uint32_t i = 0;
+    for (; i + 1 < count; i += 2) {
+        samples[i] = (uint16_t)(p[0] | ((p[1] & 0x0F) << 8));
+        samples[i + 1] = (uint16_t)((p[1] >> 4) | (p[2] << 4));
+        p += 3;
+    }
+    if (i < count) samples[i] = get_u16(p);
+    return (int)size;
+}
+
+// ---------------------------------------------------------------------------
+// Fila de quadros
+//
+// As barreiras garantem que o consumidor veja o quadro completo antes do novo head
+// e que o produtor só reescreva uma posição depois que o consumidor a liberou.
+
+void record_queue_init(record_queue_t *q) {
+    q->head = 0;
+    q->tail = 0;
+    q->dropped = 0;
+}
+
+bool record_queue_push(record_queue_t *q, const uint16_t *samples, uint16_t count, uint32_t seq,
+                       uint32_t sample_rate) {
+    uint32_t head = q->head;
+    if (head - q->tail >= RECORD_QUEUE_FRAMES) {
+        q->dropped++;
+        return false;
+    }
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    uint32_t slot = head & (RECORD_QUEUE_FRAMES - 1);
+    q->sizes[slot] = (uint16_t)record_pack(samples, count, seq, sample_rate, q->frames[slot]);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    q->head = head + 1;
+    return true;
+}
+
+bool record_queue_peek(record_queue_t *q, const uint8_t **frame, size_t *size) {
+    uint32_t tail = q->tail;
+    if (q->head == tail) return false;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    uint32_t slot = tail & (RECORD_QUEUE_FRAMES - 1);
+    *frame = q->frames[slot];
+    *size = q->sizes[slot];
+    return true;
+}
+
+void record_queue_release(record_queue_t *q) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    q->tail = q->tail + 1;
+}
@@ -0,0 +1,68 @@
+#ifndef RECORD_H
+#define RECORD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Gravação das amostras cruas do ADC pela USB.
+//
+// Cada bloco da captura vira um quadro binário (little-endian):
+//
+//     0   "AFRC"             marca de início (reencontrada pelo decodificador após perdas)
+//     4   versão (1)         1 byte
+//     5   bits (12)          1 byte
+//     6   amostras (n)       2 bytes
+//     8   sequência          4 bytes, contador de blocos da captura (lacunas = blocos perdidos)
+//     12  taxa (Hz)          4 bytes, taxa do ADC
+//     16  amostras           pares em 3 bytes: a0[7:0], a1[3:0]a0[11:8], a1[11:4]
+//                            (n ímpar: a última em 2 bytes)
+//     ..  Fletcher-16        2 bytes, sobre cabeçalho e amostras
+//
+// O empacotamento em 12 bits reduz o fluxo a 1,5 byte por amostra (96 KB/s a 64 kHz).
+// O núcleo da análise empacota os blocos numa fila de quadros (um produtor, um
+// consumidor) e o núcleo 0 os envia pela serial; fila cheia descarta o quadro, e a
+// lacuna aparece na sequência.
+
+#define RECORD_MAGIC "AFRC"
+#define RECORD_VERSION 1
+#define RECORD_BITS 12
+#define RECORD_HEADER_SIZE 16
+#define RECORD_MAX_SAMPLES 1024
+#define RECORD_FRAME_SIZE(n) (RECORD_HEADER_SIZE + ((n) * 3 + 1) / 2 + 2)
+#define RECORD_MAX_FRAME RECORD_FRAME_SIZE(RECORD_MAX_SAMPLES)
+#define RECORD_QUEUE_FRAMES 8   // Quadros na fila (potência de 2; 128 ms de folga a 64 kHz)
+
+typedef struct {
+    uint16_t count;         // Amostras no quadro
+    uint32_t seq;           // Sequência do bloco
+    uint32_t sample_rate;   // Taxa do ADC (Hz)
+} record_header_t;
+
+// Empacota `count` amostras de 12 bits (até RECORD_MAX_SAMPLES); retorna o tamanho do quadro
+size_t record_pack(const uint16_t *samples, uint16_t count, uint32_t seq, uint32_t sample_rate, uint8_t *out);
+
+// Decodifica um quadro no início de `data`. Retorna o tamanho do quadro, 0 se ainda
+// faltam bytes ou -1 se o início não é um quadro válido (marca, versão ou soma).
+int record_unpack(const uint8_t *data, size_t len, record_header_t *header, uint16_t *samples);
+
+// Fila de quadros entre o núcleo da análise e o núcleo 0
+typedef struct {
+    uint8_t frames[RECORD_QUEUE_FRAMES][RECORD_MAX_FRAME];
+    uint16_t sizes[RECORD_QUEUE_FRAMES];
+    volatile uint32_t head;      // Quadros empacotados (escrito pelo produtor)
+    volatile uint32_t tail;      // Quadros enviados (escrito pelo consumidor)
+    volatile uint32_t dropped;   // Quadros descartados com a fila cheia
+} record_queue_t;
+
+void record_queue_init(record_queue_t *q);
+
+// Produtor: empacota um bloco; false se a fila estava cheia
+bool record_queue_push(record_queue_t *q, const uint16_t *samples, uint16_t count, uint32_t seq,
+                       uint32_t sample_rate);
+
+// Consumidor: quadro mais antigo (vale até record_queue_release); false se vazia
+bool record_queue_peek(record_queue_t *q, const uint8_t **frame, size_t *size);
+void record_queue_release(record_queue_t *q);
+
+#endif // RECORD_H
@@ -1,6 +1,15 @@
 #include "ssd1306.h"
 #include "font.h"
 #include <stdlib.h>
+#include <string.h>
+
+#ifndef AFINADOR_HOST
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#else
+#include "hal.h"
+#define I2C_IC_DATA_CMD_STOP_BITS 0x200u  // Mesmo formato de IC_DATA_CMD no host
+#endif
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
   ssd->width = width;
@@ -12,6 +21,22 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
   ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
+  ssd->shadow = calloc(ssd->bufsize, sizeof(uint8_t));
+  ssd->shadow_valid = false;
+  ssd->bytes_sent = 0;
+  // Pior caso: quadro inteiro mais 8 palavras de controle por janela separada
+  ssd->tx_capacity = ssd->bufsize + 8 * (width / (SSD1306_MERGE_GAP + 2) + 1);
+  ssd->tx_words = calloc(ssd->tx_capacity, sizeof(uint16_t));
+  ssd->tx_len = 0;
+  ssd->dma_chan = -1;
+  ssd->flush_active = false;
+  ssd->flush_pending = false;
+  ssd->frames_coalesced = 0;
+  ssd->on_flush_done = NULL;
+  ssd->flush_user_data = NULL;
+#ifndef AFINADOR_HOST
+  ssd->tx_abort_source = 0;
+#endif
 }
 
 void ssd1306_config(ssd1306_t *ssd) {
@@ -42,7 +67,87 @@ void ssd1306_config(ssd1306_t *ssd) {
   ssd1306_command(ssd, SET_DISP | 0x01);
 }
 
+// Força o próximo ssd1306_send_data() a enviar o quadro inteiro
+void ssd1306_invalidate(ssd1306_t *ssd) {
+  ssd->shadow_valid = false;
+}
+
+// Acrescenta uma transação I2C ao fluxo da DMA; o último byte leva o bit de STOP
+static void ssd1306_stream_append(ssd1306_t *ssd, const uint8_t *bytes, size_t len) {
+  for (size_t i = 0; i < len; ++i)
+    ssd->tx_words[ssd->tx_len++] = bytes[i];
+  ssd->tx_words[ssd->tx_len - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+  ssd->bytes_sent += 1 + len;  // Inclui o byte de endereço da transação
+}
+
+// Acrescenta a janela de colunas [x0, x1] x páginas [p0, p1]: uma transação com os
+// 6 bytes de endereçamento e outra com os dados, copiados de ram_buffer para o fluxo
+static void ssd1306_stream_window(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1) {
+  uint8_t commands[7] = {0x00, SET_COL_ADDR, x0, x1, SET_PAGE_ADDR, p0, p1};
+  ssd1306_stream_append(ssd, commands, sizeof(commands));
+
+  // Modo de endereçamento vertical: o controlador percorre p0..p1 de cada coluna
+  size_t start = ssd->tx_len;
+  ssd->tx_words[ssd->tx_len++] = 0x40;
+  for (uint8_t x = x0; x <= x1; ++x) {
+    size_t offset = 1 + x * ssd->pages;
+    for (uint8_t p = p0; p <= p1; ++p) {
+      ssd->tx_words[ssd->tx_len++] = ssd->ram_buffer[offset + p];
+      ssd->shadow[offset + p] = ssd->ram_buffer[offset + p];
+    }
+  }
+  ssd->tx_words[ssd->tx_len - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+  ssd->bytes_sent += 1 + ssd->tx_len - start;
+}
+
+// Monta em tx_words as janelas de colunas/páginas que mudaram desde o último envio
+static void ssd1306_build_stream(ssd1306_t *ssd) {
+  ssd->tx_len = 0;
+  ssd->bytes_sent = 0;
+
+  if (!ssd->shadow_valid) {
+    ssd1306_stream_window(ssd, 0, ssd->width - 1, 0, ssd->pages - 1);
+    ssd->shadow_valid = true;
+    return;
+  }
+
+  int16_t run_start = -1, run_end = -1;  // Colunas da janela em formação
+  uint8_t run_pages = 0;                 // Páginas sujas da janela (máscara)
+
+  for (uint16_t x = 0; x <= ssd->width; ++x) {
+    // Máscara de páginas alteradas nesta coluna
+    uint8_t dirty = 0;
+    if (x < ssd->width) {
+      size_t offset = 1 + x * ssd->pages;
+      for (uint8_t p = 0; p < ssd->pages; ++p) {
+        if (ssd->ram_buffer[offset + p] != ssd->shadow[offset + p])
+          dirty |= 1 << p;
+      }
+    }
+
+    if (dirty) {
+      if (run_start < 0) run_start = x;
+      run_end = x;
+      run_pages |= dirty;
+      continue;
+    }
+
+    // Fecha a janela quando a sequência de colunas limpas fica longa ou no fim da tela
+    if (run_start >= 0 && (x == ssd->width || x - run_end > SSD1306_MERGE_GAP)) {
+      uint8_t p0 = 0, p1 = ssd->pages - 1;
+      while (!(run_pages & (1 << p0))) ++p0;
+      while (!(run_pages & (1 << p1))) --p1;
+      ssd1306_stream_window(ssd, run_start, run_end, p0, p1);
+      run_start = -1;
+      run_pages = 0;
+    }
+  }
+}
+
+#ifndef AFINADOR_HOST
+
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
+  ssd1306_wait(ssd);  // Não intercala comandos com um quadro em andamento
   ssd->port_buffer[1] = command;
   i2c_write_blocking(
     ssd->i2c_port,
@@ -53,69 +158,251 @@ void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   );
 }
 
+// Aguarda o FIFO do I2C esvaziar e o mestre ficar ocioso
+static void ssd1306_wait_bus_idle(i2c_hw_t *hw) {
+  while (!(hw->status & I2C_IC_STATUS_TFE_BITS) || (hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS))
+    tight_loop_contents();
+}
+
+// Dispara a DMA com o fluxo montado; o I2C gera START/STOP entre as transações
+static void ssd1306_start_dma(ssd1306_t *ssd) {
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+
+  if (ssd->dma_chan < 0) {
+    ssd->dma_chan = dma_claim_unused_channel(true);
+    dma_channel_config config = dma_channel_get_default_config(ssd->dma_chan);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, i2c_get_dreq(ssd->i2c_port, true));
+    dma_channel_configure(ssd->dma_chan, &config, &hw->data_cmd, ssd->tx_words, 0, false);
+  }
+
+  // Endereço do escravo: só pode mudar com o bloco ocioso e desabilitado
+  if ((hw->tar & 0x3ff) != ssd->address) {
+    ssd1306_wait_bus_idle(hw);
+    hw->enable = 0;
+    hw->tar = ssd->address;
+    hw->enable = 1;
+  }
+
+  ssd->flush_active = true;
+  dma_channel_transfer_from_buffer_now(ssd->dma_chan, ssd->tx_words, ssd->tx_len);
+}
+
+// Verifica se o envio terminou no barramento; ao terminar, libera o fluxo para o
+// próximo quadro e chama o callback de conclusão
+static void ssd1306_check_done(ssd1306_t *ssd) {
+  if (!ssd->flush_active) return;
+
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+
+  // NACK ou perda de arbitragem: o I2C esvazia o FIFO e o mantém retido até clr_tx_abrt.
+  // Descarta o envio e reenvia a tela inteira depois.
+  if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+    dma_channel_abort(ssd->dma_chan);
+    ssd->tx_abort_source = hw->tx_abrt_source;  // Lido antes de limpar
+    (void)hw->clr_tx_abrt;
+    ssd->shadow_valid = false;
+    ssd->flush_pending = true;
+  }
+
+  // A DMA parar só quer dizer que o último byte entrou no FIFO: o envio termina com o
+  // FIFO vazio e o mestre ocioso (STOP enviado). Um abort que chegue nesse meio tempo
+  // fica para a próxima chamada.
+  if (dma_channel_is_busy(ssd->dma_chan)) return;
+  if (!(hw->status & I2C_IC_STATUS_TFE_BITS) || (hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS)) return;
+  if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) return;
+
+  ssd->flush_active = false;
+  if (ssd->on_flush_done) ssd->on_flush_done(ssd->flush_user_data);
+}
+
+// Aguarda o fim do envio atual (FIFO do I2C vazio e mestre ocioso)
+void ssd1306_wait(ssd1306_t *ssd) {
+  while (ssd1306_busy(ssd))
+    tight_loop_contents();
+}
+
+#else // AFINADOR_HOST
+
+// No host o barramento é o do simulador (hal_host.c): comandos são ignorados e cada
+// quadro ocupa o barramento pelo tempo que os bytes levariam a 400 kHz. O simulador
+// recebe a tela inteira (shadow), já atualizada com as janelas do envio.
+void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
+  (void)ssd;
+  (void)command;
+}
+
+static void ssd1306_start_dma(ssd1306_t *ssd) {
+  ssd->flush_active = true;
+  ssd->flush_done_us = hal_sim_oled_transfer(ssd->shadow + 1, ssd->width, ssd->pages, ssd->bytes_sent);
+}
+
+static void ssd1306_check_done(ssd1306_t *ssd) {
+  if (!ssd->flush_active || hal_time_us() < ssd->flush_done_us) return;
+
+  ssd->flush_active = false;
+  if (ssd->on_flush_done) ssd->on_flush_done(ssd->flush_user_data);
+}
+
+void ssd1306_wait(ssd1306_t *ssd) {
+  if (ssd->flush_active) hal_busy_wait_until_us(ssd->flush_done_us);
+  ssd1306_check_done(ssd);
+}
+
+#endif // AFINADOR_HOST
+
+// Entrega o quadro desenhado em ram_buffer sem bloquear.
+// Se ainda houver um envio em andamento, o quadro fica pendente e é enviado por
+// ssd1306_poll(); quadros pendentes consecutivos se fundem no mais recente.
+// O fluxo em andamento é uma cópia, então desenhar durante o envio não causa tearing.
 void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
-    false
-  );
+  if (ssd1306_busy(ssd)) {
+    if (ssd->flush_pending) ssd->frames_coalesced++;
+    ssd->flush_pending = true;
+    return;
+  }
+
+  ssd->flush_pending = false;
+  ssd1306_build_stream(ssd);
+  if (ssd->tx_len == 0) return;  // Quadro idêntico ao da tela
+  ssd1306_start_dma(ssd);
 }
 
-void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
-  uint16_t index = (y >> 3) + (x << 3) + 1;
-  uint8_t pixel = (y & 0b111);
+// Verdadeiro enquanto a DMA ainda alimenta o FIFO do I2C
+bool ssd1306_busy(ssd1306_t *ssd) {
+  ssd1306_check_done(ssd);
+  return ssd->flush_active;
+}
+
+// Conclui envios terminados e dispara o quadro pendente. Deve ser chamada entre
+// quadros (fora do desenho), pois o quadro pendente é lido de ram_buffer.
+// Retorna verdadeiro se o barramento estiver livre e não houver nada pendente.
+bool ssd1306_poll(ssd1306_t *ssd) {
+  ssd1306_check_done(ssd);
+  if (!ssd->flush_active && ssd->flush_pending) ssd1306_send_data(ssd);
+  return !ssd->flush_active && !ssd->flush_pending;
+}
+
+void ssd1306_set_flush_callback(ssd1306_t *ssd, ssd1306_flush_callback_t callback, void *user_data) {
+  ssd->on_flush_done = callback;
+  ssd->flush_user_data = user_data;
+}
+
+// Layout do framebuffer (igual ao modo de endereçamento vertical do SSD1306):
+// ram_buffer[1 + x * pages + y / 8], bit (y % 8) de cada byte. Todas as
+// primitivas abaixo usam esse mesmo endereçamento e recortam nas bordas da tela.
+
+static inline uint8_t *ssd1306_column(ssd1306_t *ssd, uint8_t x) {
+  return &ssd->ram_buffer[1 + x * ssd->pages];
+}
+
+// Aplica a máscara a um byte: liga ou desliga os bits selecionados
+static inline void ssd1306_apply(uint8_t *byte, uint8_t mask, bool value) {
   if (value)
-    ssd->ram_buffer[index] |= (1 << pixel);
+    *byte |= mask;
   else
-    ssd->ram_buffer[index] &= ~(1 << pixel);
+    *byte &= ~mask;
 }
 
-/*
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-  uint8_t byte = value ? 0xFF : 0x00;
-  for (uint8_t i = 1; i < ssd->bufsize; ++i)
-    ssd->ram_buffer[i] = byte;
-}*/
+// Máscaras por página do intervalo vertical [y0, y1] (já recortado)
+static void ssd1306_span_masks(uint8_t y0, uint8_t y1, uint8_t *p0, uint8_t *p1, uint8_t *first, uint8_t *last) {
+  *p0 = y0 >> 3;
+  *p1 = y1 >> 3;
+  *first = 0xFF << (y0 & 7);
+  *last = 0xFF >> (7 - (y1 & 7));
+  if (*p0 == *p1) {
+    *first &= *last;
+    *last = *first;
+  }
+}
+
+// Preenche [y0, y1] de uma coluna: bytes inteiros no meio, máscaras nas pontas
+static inline void ssd1306_column_span(uint8_t *column, uint8_t p0, uint8_t p1, uint8_t first, uint8_t last, bool value) {
+  ssd1306_apply(&column[p0], first, value);
+  if (p1 == p0) return;
+  uint8_t full = value ? 0xFF : 0x00;
+  for (uint8_t p = p0 + 1; p < p1; ++p)
+    column[p] = full;
+  ssd1306_apply(&column[p1], last, value);
+}
+
+void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+  if (x >= ssd->width || y >= ssd->height) return;
+  ssd1306_apply(&ssd1306_column(ssd, x)[y >> 3], 1 << (y & 7), value);
+}
 
 void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
-    }
+  memset(ssd->ram_buffer + 1, value ? 0xFF : 0x00, ssd->bufsize - 1);
 }
 
+// Linha vertical: um byte (ou máscara) por página
+void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
+  if (y0 > y1) { uint8_t t = y0; y0 = y1; y1 = t; }
+  if (x >= ssd->width || y0 >= ssd->height) return;
+  if (y1 >= ssd->height) y1 = ssd->height - 1;
 
+  uint8_t p0, p1, first, last;
+  ssd1306_span_masks(y0, y1, &p0, &p1, &first, &last);
+  ssd1306_column_span(ssd1306_column(ssd, x), p0, p1, first, last, value);
+}
 
-void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
-  for (uint8_t x = left; x < left + width; ++x) {
-    ssd1306_pixel(ssd, x, top, value);
-    ssd1306_pixel(ssd, x, top + height - 1, value);
-  }
-  for (uint8_t y = top; y < top + height; ++y) {
-    ssd1306_pixel(ssd, left, y, value);
-    ssd1306_pixel(ssd, left + width - 1, y, value);
+// Linha horizontal: uma máscara, aplicada ao byte da página em cada coluna. Com o
+// quadro em colunas (endereçamento vertical) esses bytes ficam a `pages` de distância,
+// então não há escrita em bloco: o custo é o da versão por pixel, só sem recortes por ponto.
+void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
+  if (x0 > x1) { uint8_t t = x0; x0 = x1; x1 = t; }
+  if (y >= ssd->height || x0 >= ssd->width) return;
+  if (x1 >= ssd->width) x1 = ssd->width - 1;
+
+  const uint8_t stride = ssd->pages;
+  uint8_t *byte = ssd1306_column(ssd, x0) + (y >> 3);
+  uint8_t *end = byte + (x1 - x0 + 1) * stride;
+  uint8_t mask = 1 << (y & 7);
+  if (value) {
+    for (; byte < end; byte += stride) *byte |= mask;
+  } else {
+    mask = ~mask;
+    for (; byte < end; byte += stride) *byte &= mask;
   }
+}
+
+void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
+  if (width == 0 || height == 0 || left >= ssd->width || top >= ssd->height) return;
+  uint16_t right = left + width - 1;
+  uint16_t bottom = top + height - 1;
 
   if (fill) {
-    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
-      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
-        ssd1306_pixel(ssd, x, y, value);
-      }
-    }
+    // Máscaras de página calculadas uma vez e aplicadas a cada coluna
+    uint8_t y1 = bottom < ssd->height ? bottom : ssd->height - 1;
+    uint8_t x1 = right < ssd->width ? right : ssd->width - 1;
+    uint8_t p0, p1, first, last;
+    ssd1306_span_masks(top, y1, &p0, &p1, &first, &last);
+    for (uint8_t x = left; x <= x1; ++x)
+      ssd1306_column_span(ssd1306_column(ssd, x), p0, p1, first, last, value);
+    return;
   }
+
+  uint8_t x1 = right < 255 ? right : 255;
+  uint8_t y1 = bottom < 255 ? bottom : 255;
+  ssd1306_hline(ssd, left, x1, top, value);
+  if (bottom < ssd->height) ssd1306_hline(ssd, left, x1, bottom, value);
+  ssd1306_vline(ssd, left, top, y1, value);
+  if (right < ssd->width) ssd1306_vline(ssd, right, top, y1, value);
 }
 
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
+    // Linhas retas usam as primitivas por byte
+    if (y0 == y1) {
+        ssd1306_hline(ssd, x0, x1, y0, value);
+        return;
+    }
+    if (x0 == x1) {
+        ssd1306_vline(ssd, x0, y0, y1, value);
+        return;
+    }
+
     int dx = abs(x1 - x0);
     int dy = abs(y1 - y0);
 
@@ -143,42 +430,39 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
     }
 }
 
+// ---------------------------------------------------------------------------
+// Texto. Glifos e rótulos já estão no formato de página (font.h): cada byte é uma
+// coluna de 8 pixels, copiada inteira quando y é múltiplo de 8 e dividida entre duas
+// páginas nos demais casos. O desenho é opaco: o fundo da célula é apagado.
 
-void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
-  for (uint8_t x = x0; x <= x1; ++x)
-    ssd1306_pixel(ssd, x, y, value);
-}
+// Copia colunas de 8 pixels de altura para (x, y), recortando na borda direita
+static void ssd1306_blit(ssd1306_t *ssd, const uint8_t *columns, uint8_t count, uint8_t x, uint8_t y) {
+  if (x >= ssd->width || y >= ssd->height) return;
+  if (count > ssd->width - x) count = ssd->width - x;
 
-void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
-  for (uint8_t y = y0; y <= y1; ++y)
-    ssd1306_pixel(ssd, x, y, value);
+  const uint8_t stride = ssd->pages;
+  uint8_t page = y >> 3;
+  uint8_t shift = y & 7;
+  uint8_t *byte = ssd1306_column(ssd, x) + page;
+  if (!shift) {
+    for (uint8_t i = 0; i < count; ++i) byte[i * stride] = columns[i];
+    return;
+  }
+
+  bool has_next = page + 1 < ssd->pages;
+  uint8_t keep_low = 0xFF >> (8 - shift);  // Bits acima do texto na primeira página
+  for (uint8_t i = 0; i < count; ++i) {
+    uint8_t *column = byte + i * stride;
+    column[0] = (column[0] & keep_low) | (columns[i] << shift);
+    if (has_next)
+      column[1] = (column[1] & ~keep_low) | (columns[i] >> (8 - shift));
+  }
 }
 
 // Função para desenhar um caractere
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
 {
-  uint16_t index = 0;
-  char ver=c;
-  if (c >= 'A' && c <= 'Z')
-  {
-    index = (c - 'A' + 11) * 8; // Para letras maiúsculas
-  }
-  else if (c >= 'a' && c <= 'z') {
-    index = (c - 'a' + 37) * 8; // Adiciona o deslocamento necessário para letras minúsculas
-  }
-  else  if (c >= '0' && c <= '9')
-  {
-    index = (c - '0' + 1) * 8; // Adiciona o deslocamento necessário
-  }
-  
-  for (uint8_t i = 0; i < 8; ++i)
-  {
-    uint8_t line = font[index + i];
-    for (uint8_t j = 0; j < 8; ++j)
-    {
-      ssd1306_pixel(ssd, x + i, y + j, line & (1 << j));
-    }
-  }
+  ssd1306_blit(ssd, &font[FONT_GLYPH(c)], FONT_WIDTH, x, y);
 }
 
 // Função para desenhar uma string
@@ -200,9 +484,94 @@ void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
   }
 }
 
+// Espalha os 8 bits de uma coluna do glifo em 8 x scale bits (cada pixel vira scale)
+static uint32_t ssd1306_stretch(uint8_t line, uint8_t scale) {
+  uint32_t block = (1u << scale) - 1, bits = 0;
+  for (uint8_t j = 0; line; ++j, line >>= 1)
+    if (line & 1) bits |= block << (j * scale);
+  return bits;
+}
+
+// Texto ampliado: cada coluna do glifo é esticada uma vez e escrita em scale colunas,
+// página a página (opaco, sem quebra de linha)
+void ssd1306_draw_string_scaled(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y, uint8_t scale) {
+  if (scale < 1) scale = 1;
+  if (scale > SSD1306_MAX_SCALE) scale = SSD1306_MAX_SCALE;
+  if (y >= ssd->height) return;
+
+  // Páginas tocadas e máscara do texto em cada uma (altura 8 x scale a partir de y)
+  uint8_t height = 8 * scale;
+  uint8_t shift = y & 7;
+  uint8_t first = y >> 3;
+  uint8_t pages = (shift + height + 7) >> 3;
+  if (first + pages > ssd->pages) pages = ssd->pages - first;
+  uint64_t area = (((uint64_t)1 << height) - 1) << shift;
+
+  for (; *str; ++str) {
+    const uint8_t *glyph = &font[FONT_GLYPH(*str)];
+    for (uint8_t i = 0; i < FONT_WIDTH; ++i) {
+      uint64_t bits = (uint64_t)ssd1306_stretch(glyph[i], scale) << shift;
+      for (uint8_t k = 0; k < scale; ++k, ++x) {
+        if (x >= ssd->width) return;
+        uint8_t *column = ssd1306_column(ssd, x) + first;
+        for (uint8_t p = 0; p < pages; ++p) {
+          uint8_t mask = (uint8_t)(area >> (8 * p));
+          column[p] = (column[p] & ~mask) | (uint8_t)(bits >> (8 * p));
+        }
+      }
+    }
+  }
+}
+
+// Cache dos rótulos: colunas já montadas de cada string constante; com todas as
+// posições ocupadas, a usada há mais tempo é reaproveitada
+typedef struct {
+  const char *text;
+  uint32_t last_use;  // label_clock no último desenho (0 = posição livre)
+  uint8_t width;
+  uint8_t columns[SSD1306_LABEL_COLUMNS];
+} ssd1306_label_t;
+
+static ssd1306_label_t labels[SSD1306_LABEL_SLOTS];
+static uint32_t label_clock = 0;
+static uint32_t label_hits = 0;
+static uint32_t label_misses = 0;
+
+static const ssd1306_label_t *ssd1306_label(const char *text) {
+  ssd1306_label_t *label = &labels[0];
+  ++label_clock;
+  for (uint8_t i = 0; i < SSD1306_LABEL_SLOTS; ++i) {
+    if (labels[i].text == text) {
+      labels[i].last_use = label_clock;
+      label_hits++;
+      return &labels[i];
+    }
+    if (labels[i].last_use < label->last_use) label = &labels[i];
+  }
+
+  label_misses++;
+  label->text = text;
+  label->last_use = label_clock;
+  label->width = 0;
+  for (; *text && label->width + FONT_WIDTH <= SSD1306_LABEL_COLUMNS; ++text) {
+    memcpy(&label->columns[label->width], &font[FONT_GLYPH(*text)], FONT_WIDTH);
+    label->width += FONT_WIDTH;
+  }
+  return label;
+}
+
+void ssd1306_draw_label(ssd1306_t *ssd, const char *text, uint8_t x, uint8_t y) {
+  const ssd1306_label_t *label = ssd1306_label(text);
+  ssd1306_blit(ssd, label->columns, label->width, x, y);
+}
+
+void ssd1306_label_stats(uint32_t *hits, uint32_t *misses) {
+  *hits = label_hits;
+  *misses = label_misses;
+}
 
 void ssd1306_draw_pixel(ssd1306_t *ssd, int x, int y) {
   if (x >= 0 && x < ssd->width && y >= 0 && y < ssd->height) {
-      ssd->ram_buffer[x + (y / 8) * ssd->width] |= (1 << (y & 7));
+      ssd1306_pixel(ssd, x, y, true);
   }
 }
\ No newline at end of file
@@ -3,7 +3,12 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
+#ifdef AFINADOR_HOST
+typedef struct i2c_inst i2c_inst_t;  // Sem barramento no host
+#else
 #include "hardware/i2c.h"
+#endif
 
 #define WIDTH 128
 #define HEIGHT 64
@@ -28,6 +33,12 @@ typedef enum {
   SET_CHARGE_PUMP = 0x8D
 } ssd1306_command_t;
 
+// Colunas limpas toleradas dentro de uma mesma janela de envio: enviar poucas
+// colunas a mais custa menos que os comandos de endereçamento de outra janela
+#define SSD1306_MERGE_GAP 4
+
+typedef void (*ssd1306_flush_callback_t)(void *user_data);
+
 typedef struct {
   uint8_t width, height, pages, address;
   i2c_inst_t *i2c_port;
@@ -35,6 +46,26 @@ typedef struct {
   uint8_t *ram_buffer;
   size_t bufsize;
   uint8_t port_buffer[2];
+  uint8_t *shadow;        // Conteúdo da tela após o envio em andamento (mesmo layout de ram_buffer)
+  bool shadow_valid;      // false força o envio do quadro completo
+  uint32_t bytes_sent;    // Bytes transmitidos no barramento pelo último envio
+  // Envio assíncrono: o quadro é copiado para tx_words (palavras IC_DATA_CMD,
+  // com STOP no fim de cada transação) e a DMA o entrega ao FIFO do I2C,
+  // enquanto a aplicação já desenha o próximo quadro em ram_buffer
+  uint16_t *tx_words;
+  size_t tx_capacity;
+  size_t tx_len;
+  int dma_chan;                            // Canal de DMA (-1 até o primeiro envio)
+  volatile bool flush_active;              // Transferência em andamento
+  bool flush_pending;                      // Quadro mais novo aguardando o barramento
+  uint32_t frames_coalesced;               // Quadros substituídos por um mais novo antes do envio
+  ssd1306_flush_callback_t on_flush_done;  // Chamado por ssd1306_poll() ao fim de cada envio
+  void *flush_user_data;
+#ifdef AFINADOR_HOST
+  uint64_t flush_done_us;                  // Fim do envio no barramento simulado (hal_host.c)
+#else
+  uint32_t tx_abort_source;                // IC_TX_ABRT_SOURCE do último envio abortado
+#endif
 } ssd1306_t;
 
 // Funções principais
@@ -42,6 +73,13 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
 void ssd1306_send_data(ssd1306_t *ssd);
+void ssd1306_invalidate(ssd1306_t *ssd);
+
+// Controle do envio assíncrono
+bool ssd1306_poll(ssd1306_t *ssd);
+bool ssd1306_busy(ssd1306_t *ssd);
+void ssd1306_wait(ssd1306_t *ssd);
+void ssd1306_set_flush_callback(ssd1306_t *ssd, ssd1306_flush_callback_t callback, void *user_data);
 
 // Funções de desenho
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
@@ -50,8 +88,28 @@ void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value);
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
+
+// Texto com a fonte 8x8 de font.h (ASCII imprimível; outros bytes saem em branco).
+// Em y múltiplo de 8 cada coluna é um byte copiado para o framebuffer.
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+
+// Texto ampliado scale vezes (1 a SSD1306_MAX_SCALE), para leituras grandes como a
+// frequência; numa linha só, cortado na borda
+#define SSD1306_MAX_SCALE 4
+void ssd1306_draw_string_scaled(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y, uint8_t scale);
+
+// Rótulo fixo: as colunas do texto são montadas na primeira chamada e depois só
+// copiadas. A chave é o endereço, então text deve ser uma string constante (literal
+// ou tabela), nunca um buffer reescrito entre quadros. Até SSD1306_LABEL_COLUMNS / 8
+// caracteres, sem quebra de linha. O cache cabe todos os rótulos do main.c (menu,
+// títulos das telas e nomes dos perfis, ~3 KB); além disso, remonta o usado há mais tempo.
+#define SSD1306_LABEL_SLOTS 24
+#define SSD1306_LABEL_COLUMNS 128
+void ssd1306_draw_label(ssd1306_t *ssd, const char *text, uint8_t x, uint8_t y);
+
+// Acertos e faltas do cache de rótulos desde o início
+void ssd1306_label_stats(uint32_t *hits, uint32_t *misses);
 void ssd1306_draw_pixel(ssd1306_t *ssd, int x, int y);
 
 
@@ -0,0 +1,114 @@
+#include "strobe.h"
+#include <math.h>
+
+#define TABLE_SIZE (1u << STROBE_TABLE_BITS)
+#define TABLE_QUARTER (TABLE_SIZE / 4)
+#define DC_SHIFT 8                      // Rastreador de DC: média exponencial de 256 amostras
+
+// Seno em Q15 (gerado uma única vez, como os twiddles da FFT)
+static int16_t sine[TABLE_SIZE];
+static bool sine_ready = false;
+
+static void strobe_build_sine(void) {
+    for (uint32_t k = 0; k < TABLE_SIZE; k++) {
+        sine[k] = (int16_t)lrintf(sinf(6.28318530718f * (float)k / TABLE_SIZE) * 32767.0f);
+    }
+    sine_ready = true;
+}
+
+void strobe_init(strobe_t *st, uint32_t sample_rate) {
+    if (!sine_ready) strobe_build_sine();
+
+    st->sample_rate = sample_rate;
+    st->dc = 2048 << DC_SHIFT;
+    st->phase = 0;
+    st->angle = 0;
+    st->level = 0;
+    strobe_set_target(st, 0);
+}
+
+void strobe_set_target(strobe_t *st, fixed_t target_freq) {
+    st->target = target_freq;
+    st->increment = (uint32_t)(((uint64_t)(uint32_t)target_freq << 16) / st->sample_rate);
+
+    // Corte dos filtros em ~alvo / 2pi: o 2º harmônico (que cai a +alvo em banda base)
+    // é atenuado em mais de 30 dB, e notas agudas ainda passam com +-50 cents de desvio
+    st->filter_shift = 0;
+    while (((int64_t)st->sample_rate << FIXED_SHIFT >> st->filter_shift) > target_freq) st->filter_shift++;
+    st->i1 = st->q1 = st->i2 = st->q2 = st->i3 = st->q3 = 0;
+    st->step_count = 0;
+    st->settle = 12u << st->filter_shift;  // Doze constantes de tempo dos filtros
+    st->drift = 0;
+    st->measures = 0;
+    st->has_angle = false;
+}
+
+// Mede o ângulo do fasor e acumula a variação desde a medida anterior
+static void strobe_measure(strobe_t *st) {
+    int32_t magnitude;
+    uint32_t angle = fixed_atan2(st->q3, st->i3, &magnitude);
+
+    // |I + jQ| = A / 2 x 32767 para uma senoide de amplitude A
+    st->level = (uint16_t)(((int64_t)magnitude << 2) / FIXED_CORDIC_GAIN);
+    if (st->level < STROBE_MIN_LEVEL) {
+        st->has_angle = false;  // Fase sem sentido: recomeça na próxima medida com sinal
+        return;
+    }
+
+    if (st->has_angle) {
+        int32_t delta = (int32_t)(angle - st->angle);  // Diferença com volta: -1/2 a +1/2 volta
+        if (st->measures == 0) st->drift = delta;
+        else st->drift += (delta - st->drift) >> STROBE_AVERAGE_SHIFT;
+        if (st->measures < UINT16_MAX) st->measures++;
+    }
+    st->angle = angle;
+    st->has_angle = true;
+}
+
+void strobe_process(strobe_t *st, const uint16_t *samples, uint32_t count) {
+    if (st->target == 0) return;
+
+    const uint8_t k = st->filter_shift;
+    int32_t dc = st->dc;
+    for (uint32_t n = 0; n < count; n++) {
+        dc += (((int32_t)samples[n] << DC_SHIFT) - dc) >> DC_SHIFT;
+        int32_t x = (int32_t)samples[n] - (dc >> DC_SHIFT);
+
+        // Mistura com o oscilador local: I = x cos, Q = -x sen
+        uint32_t index = st->phase >> (32 - STROBE_TABLE_BITS);
+        int32_t s = sine[index];
+        int32_t c = sine[(index + TABLE_QUARTER) & (TABLE_SIZE - 1)];
+        st->phase += st->increment;
+
+        // Passa-baixas de três polos: resta só a componente perto do alvo
+        st->i1 += (x * c - st->i1) >> k;
+        st->q1 += (-x * s - st->q1) >> k;
+        st->i2 += (st->i1 - st->i2) >> k;
+        st->q2 += (st->q1 - st->q2) >> k;
+        st->i3 += (st->i2 - st->i3) >> k;
+        st->q3 += (st->q2 - st->q3) >> k;
+
+        if (st->settle > 0) {
+            st->settle--;
+            continue;
+        }
+        if (++st->step_count < STROBE_STEP) continue;
+        st->step_count = 0;
+        strobe_measure(st);
+    }
+    st->dc = dc;
+}
+
+bool strobe_read(const strobe_t *st, strobe_reading_t *reading) {
+    reading->angle = st->angle;
+    reading->level = st->level;
+    reading->cents = 0;
+    reading->valid = st->target != 0 && st->has_angle && st->measures >= (1u << STROBE_AVERAGE_SHIFT);
+    if (!reading->valid) return false;
+
+    // df = drift / 2^32 voltas a cada STROBE_STEP amostras (Hz, Q16.16)
+    int64_t df = ((int64_t)st->drift * st->sample_rate) / ((int64_t)STROBE_STEP << 16);
+
+    reading->cents = fixed_cents((fixed_t)df, st->target);
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef STROBE_H
+#define STROBE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixed.h"
+
+// Afinador estroboscópico: mistura a entrada com um oscilador local (NCO) na
+// frequência da nota alvo e acompanha a deriva de fase do resultado em banda base.
+// Se a corda está a df Hz do alvo, o fasor (I, Q) gira a df voltas por segundo:
+// a velocidade de giro dá o desvio em cents e o ângulo move o desenho do estrobo.
+//
+// Por amostra: uma consulta à tabela de senos, dois produtos e seis filtros de
+// um polo (deslocamentos e somas). A cada STROBE_STEP amostras, um CORDIC mede o
+// ângulo e a diferença para a medida anterior entra numa média exponencial.
+
+#define STROBE_TABLE_BITS 8          // Tabela de seno com 256 pontos (Q15)
+#define STROBE_STEP 32               // Amostras entre medidas de fase
+#define STROBE_AVERAGE_SHIFT 5       // Média de 2^5 medidas (~0,26 s a 4 kHz)
+#define STROBE_MIN_LEVEL 20          // Amplitude mínima da componente no alvo (contagens do ADC)
+
+typedef struct {
+    uint32_t sample_rate;       // Taxa das amostras recebidas (Hz)
+    uint8_t filter_shift;       // Polo dos filtros: sample_rate / 2^shift <= alvo (corte ~ alvo / 2pi)
+    int32_t dc;                 // Nível DC do microfone (Q8)
+    fixed_t target;             // Frequência do oscilador local (Hz, Q16.16); 0 = sem alvo
+    uint32_t phase;             // Fase do NCO (2^32 = uma volta)
+    uint32_t increment;         // Incremento de fase por amostra
+    int32_t i1, q1, i2, q2, i3, q3; // Três estágios de passa-baixas por componente
+    uint32_t step_count;        // Amostras desde a última medida de fase
+    uint32_t settle;            // Amostras a descartar enquanto os filtros acomodam
+    uint32_t angle;             // Último ângulo medido do fasor (2^32 = uma volta)
+    int32_t drift;              // Média da variação do ângulo por medida
+    uint16_t measures;          // Medidas acumuladas na média (satura)
+    uint16_t level;             // Amplitude estimada da componente no alvo
+    bool has_angle;             // angle vale como referência para a próxima medida
+} strobe_t;
+
+// Leitura do estrobo
+typedef struct {
+    bool valid;         // Há sinal no alvo e a média já acomodou
+    fixed_t cents;      // Desvio em relação ao alvo (Q16.16, resolução abaixo de 0,1 cent)
+    uint32_t angle;     // Ângulo do fasor: gira df voltas por segundo (desenho do estrobo)
+    uint16_t level;     // Amplitude da componente no alvo (contagens do ADC)
+} strobe_reading_t;
+
+void strobe_init(strobe_t *st, uint32_t sample_rate);
+
+// Troca a frequência do oscilador local e reinicia o acompanhamento da fase
+void strobe_set_target(strobe_t *st, fixed_t target_freq);
+
+// Processa amostras do ADC (12 bits) consecutivas às da chamada anterior
+void strobe_process(strobe_t *st, const uint16_t *samples, uint32_t count);
+
+// Desvio atual; retorna reading->valid
+bool strobe_read(const strobe_t *st, strobe_reading_t *reading);
+
+#endif // STROBE_H
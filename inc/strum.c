@@ -0,0 +1,240 @@
+#include "strum.h"
+#include "note_map.h"
+#include <math.h>
+
+#define DC_SHIFT 8                      // Rastreador de DC: média exponencial de 256 amostras
+
+const uint8_t strum_standard_tuning[STRUM_STRINGS] = {40, 45, 50, 55, 59, 64};
+
+// Janela de Hann em Q15 (gerada uma única vez, como os twiddles da FFT)
+static int16_t window[STRUM_BLOCK];
+static bool window_ready = false;
+
+static void strum_build_window(void) {
+    for (uint32_t n = 0; n < STRUM_BLOCK; n++) {
+        window[n] = (int16_t)lrintf((0.5f - 0.5f * cosf(6.28318530718f * (float)n / STRUM_BLOCK)) * 32767.0f);
+    }
+    window_ready = true;
+}
+
+// (s * c) >> 14 só com produtos de 32 bits (o M0+ não tem multiplicação 32x32 -> 64):
+// s = hi * 2^16 + lo, e hi * c * 2^16 é múltiplo de 2^14, então o resultado é exato
+static inline int32_t mul_q14(int32_t s, int16_t c) {
+    int32_t hi = s >> 16;
+    int32_t lo = (int32_t)(s & 0xFFFF);
+    return ((hi * c) << 2) + ((lo * c) >> 14);
+}
+
+void strum_init(strum_t *st, uint32_t sample_rate) {
+    if (!window_ready) strum_build_window();
+
+    st->bank_rate = sample_rate / STRUM_DECIMATION;
+    st->dc = 2048 << DC_SHIFT;
+    for (uint32_t k = 0; k < STRUM_HISTORY; k++) st->history[k] = 0;
+    st->odd = false;
+    strum_set_strings(st, strum_standard_tuning, STRUM_STRINGS);
+}
+
+// Coeficientes calculados uma vez por troca de afinação (float só na configuração)
+void strum_set_strings(strum_t *st, const uint8_t *midi, uint8_t strings) {
+    if (strings == 0 || strings > STRUM_STRINGS) strings = STRUM_STRINGS;
+    st->count = 0;
+    st->reading.count = strings;
+    st->resonators_used = (strings * STRUM_HARMONICS + 3) & ~3u;
+
+    // As posições sem corda repetem a última (o grupo de quatro é atualizado inteiro)
+    uint32_t last = strings - 1u;
+    for (uint32_t i = 0; i < STRUM_STRINGS; i++) {
+        uint8_t note = midi[(i < strings) ? i : last];
+        st->target[i] = note_map_frequency(note);
+
+        strum_string_t *string = &st->reading.strings[i];
+        string->midi = note;
+        string->valid = false;
+        string->cents = 0;
+        string->level = 0;
+
+        for (uint32_t h = 0; h < STRUM_HARMONICS; h++) {
+            strum_resonator_t *r = &st->resonators[i * STRUM_HARMONICS + h];
+            float f = (float)st->target[i] * (float)(h + 1) / FIXED_ONE;
+            float w = 6.28318530718f * f / (float)st->bank_rate;
+            long coeff = lrintf(2.0f * cosf(w) * 16384.0f);
+            if (coeff > 32767) coeff = 32767;
+
+            // A referência de fase usa a frequência exata do coeficiente quantizado
+            float wq = acosf((float)coeff / 32768.0f);
+            r->coeff = (int16_t)coeff;
+            r->sin_w = (int16_t)lrintf(sinf(wq) * 32767.0f);
+            r->freq = (fixed_t)lrintf(wq * (float)st->bank_rate / 6.28318530718f * FIXED_ONE);
+            r->hop_turns = (uint32_t)((((uint64_t)(uint32_t)r->freq * STRUM_BLOCK) << 16) / st->bank_rate);
+            r->s1 = r->s2 = 0;
+            r->has_angle = false;
+            r->enabled = 3 * f < (float)st->bank_rate;
+        }
+    }
+}
+
+// Fim de um bloco: fase e amplitude de cada ressonador e desvio de cada corda
+static void strum_estimate(strum_t *st) {
+    for (uint32_t i = 0; i < st->reading.count; i++) {
+        fixed_t cents[STRUM_HARMONICS];
+        uint16_t level[STRUM_HARMONICS];
+        bool ok[STRUM_HARMONICS];
+
+        for (uint32_t h = 0; h < STRUM_HARMONICS; h++) {
+            strum_resonator_t *r = &st->resonators[i * STRUM_HARMONICS + h];
+
+            // y = s1 - e^(-jw) s2: a DFT do bloco, com fase referida à última amostra
+            int32_t re = r->s1 - (int32_t)(((int64_t)r->s2 * r->coeff) >> 15);
+            int32_t im = (int32_t)(((int64_t)r->s2 * r->sin_w) >> 15);
+            r->s1 = r->s2 = 0;
+
+            int32_t magnitude;
+            uint32_t angle = fixed_atan2(im >> 2, re >> 2, &magnitude);
+
+            // Com a janela de Hann, |y| = A x N / 4 para uma senoide de amplitude A
+            level[h] = (uint16_t)(((int64_t)magnitude << 20) / ((int64_t)STRUM_BLOCK * FIXED_CORDIC_GAIN));
+            if (!r->enabled) level[h] = 0;
+            ok[h] = r->has_angle && level[h] >= STRUM_MIN_LEVEL;
+
+            // df = (avanço medido - avanço esperado) / 2^32 voltas por bloco (Hz, Q16.16)
+            int32_t delta = (int32_t)(angle - r->angle - r->hop_turns);
+            int64_t df = ((int64_t)delta * st->bank_rate) / ((int64_t)STRUM_BLOCK << 16);
+            fixed_t harmonic = st->target[i] * (fixed_t)(h + 1);
+            cents[h] = fixed_cents(r->freq + (fixed_t)df - harmonic, harmonic);
+
+            r->angle = angle;
+            r->has_angle = level[h] >= STRUM_MIN_LEVEL;
+        }
+
+        // Média ponderada pela amplitude quando os harmônicos concordam; senão, o
+        // fundamental (o 2º harmônico dá a volta com metade do desvio)
+        strum_string_t *string = &st->reading.strings[i];
+        fixed_t estimate;
+        if (ok[0] && ok[1] && fixed_abs(cents[1] - cents[0]) < STRUM_AGREEMENT) {
+            estimate = (fixed_t)(((int64_t)cents[0] * level[0] + (int64_t)cents[1] * level[1]) /
+                                 (level[0] + level[1]));
+        } else if (ok[0]) {
+            estimate = cents[0];
+        } else if (ok[1]) {
+            estimate = cents[1];
+        } else {
+            string->valid = false;
+            string->level = 0;
+            continue;
+        }
+
+        string->cents = string->valid ? string->cents + ((estimate - string->cents) >> 1) : estimate;
+        string->level = (level[0] > level[1]) ? level[0] : level[1];
+        string->valid = true;
+    }
+}
+
+_Static_assert((STRUM_STRINGS * STRUM_HARMONICS) % 4 == 0, "o banco é percorrido de quatro em quatro");
+
+// Passa amostras já decimadas (sem DC) pelo banco; retorna true se algum bloco foi concluído
+static bool strum_bank(strum_t *st, const int16_t *samples, uint32_t count) {
+    static int16_t windowed[STRUM_BLOCK];
+    bool estimated = false;
+
+    while (count > 0) {
+        // Trecho até o fim do bloco atual: janela aplicada uma vez, depois cada
+        // ressonador percorre o trecho inteiro com o estado em registradores
+        uint32_t chunk = STRUM_BLOCK - st->count;
+        if (chunk > count) chunk = count;
+
+        for (uint32_t n = 0; n < chunk; n++) {
+            windowed[n] = (int16_t)(((int32_t)samples[n] * window[st->count + n]) >> 15);
+        }
+
+        // Recorrência de Goertzel, s = x + 2 cos(w) s1 - s2, quatro ressonadores por
+        // vez: as recorrências independentes se intercalam e o estado fica em registradores
+        for (uint32_t k = 0; k < st->resonators_used; k += 4) {
+            strum_resonator_t *r = &st->resonators[k];
+            int32_t a1 = r[0].s1, a2 = r[0].s2, b1 = r[1].s1, b2 = r[1].s2;
+            int32_t c1 = r[2].s1, c2 = r[2].s2, d1 = r[3].s1, d2 = r[3].s2;
+            const int16_t ca = r[0].coeff, cb = r[1].coeff, cc = r[2].coeff, cd = r[3].coeff;
+            for (uint32_t n = 0; n < chunk; n++) {
+                int32_t x = windowed[n];
+                int32_t a = x + mul_q14(a1, ca) - a2;
+                int32_t b = x + mul_q14(b1, cb) - b2;
+                int32_t c = x + mul_q14(c1, cc) - c2;
+                int32_t d = x + mul_q14(d1, cd) - d2;
+                a2 = a1;
+                a1 = a;
+                b2 = b1;
+                b1 = b;
+                c2 = c1;
+                c1 = c;
+                d2 = d1;
+                d1 = d;
+            }
+            r[0].s1 = a1;
+            r[0].s2 = a2;
+            r[1].s1 = b1;
+            r[1].s2 = b2;
+            r[2].s1 = c1;
+            r[2].s2 = c2;
+            r[3].s1 = d1;
+            r[3].s2 = d2;
+        }
+
+        samples += chunk;
+        count -= chunk;
+        st->count += chunk;
+        if (st->count == STRUM_BLOCK) {
+            st->count = 0;
+            strum_estimate(st);
+            estimated = true;
+        }
+    }
+    return estimated;
+}
+
+bool strum_process(strum_t *st, const uint16_t *samples, uint32_t count) {
+    static int16_t decimated[STRUM_BLOCK];
+    uint32_t produced = 0;
+    bool estimated = false;
+
+    // Histórico em registradores: h0 = x[n - 1], ..., h5 = x[n - 6]
+    int32_t dc = st->dc;
+    int32_t h0 = st->history[0], h1 = st->history[1], h2 = st->history[2];
+    int32_t h3 = st->history[3], h4 = st->history[4], h5 = st->history[5];
+    bool odd = st->odd;
+    for (uint32_t n = 0; n < count; n++) {
+        dc += (((int32_t)samples[n] << DC_SHIFT) - dc) >> DC_SHIFT;
+        int32_t x = (int32_t)samples[n] - (dc >> DC_SHIFT);
+
+        // Meia-banda [-1 0 9 16 9 0 -1] / 32 centrado em x[n - 3], uma saída a cada
+        // duas entradas (os produtos por constantes viram deslocamentos e somas)
+        if (odd) {
+            decimated[produced++] = (int16_t)((16 * h2 + 9 * (h1 + h3) - (x + h5)) >> 5);
+            if (produced == STRUM_BLOCK) {
+                estimated |= strum_bank(st, decimated, produced);
+                produced = 0;
+            }
+        }
+        odd = !odd;
+        h5 = h4;
+        h4 = h3;
+        h3 = h2;
+        h2 = h1;
+        h1 = h0;
+        h0 = x;
+    }
+    st->dc = dc;
+    st->history[0] = h0;
+    st->history[1] = h1;
+    st->history[2] = h2;
+    st->history[3] = h3;
+    st->history[4] = h4;
+    st->history[5] = h5;
+    st->odd = odd;
+
+    if (produced > 0) estimated |= strum_bank(st, decimated, produced);
+    return estimated;
+}
+
+void strum_read(const strum_t *st, strum_reading_t *reading) {
+    *reading = st->reading;
+}
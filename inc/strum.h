@@ -0,0 +1,89 @@
+#ifndef STRUM_H
+#define STRUM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixed.h"
+
+// Conferência de todas as cordas num único toque (rasgueado com as cordas soltas).
+//
+// A entrada passa por um meia-banda curto (o harmônico mais agudo conferido, o 2º do
+// E agudo, fica em 659 Hz) e, na metade da taxa, um banco de ressonadores de
+// Goertzel, um na fundamental e outro no 2º harmônico de cada corda, é atualizado a
+// cada amostra (janela de Hann, blocos de STRUM_BLOCK amostras). Ao fim de cada
+// bloco, o avanço de fase de cada ressonador em relação ao bloco anterior dá o
+// desvio de frequência com resolução bem menor que um bin.
+//
+// Custo por amostra decimada: o meia-banda (só somas e deslocamentos), um produto
+// da janela e, por ressonador, uma multiplicação Q14 (dois produtos de 32 bits) e
+// duas somas. Com 12 ressonadores, 512 amostras de entrada custam menos que uma FFT
+// real de 512 pontos (ver fft_forward e strum_bank no bench_dsp).
+//
+// O avanço de fase só é inequívoco para |df| < taxa do banco / (2 x STRUM_BLOCK):
+// 3,9 Hz com entrada a 4 kHz, ou seja, cerca de +-80 cents no E grave e +-20 cents
+// no E agudo.
+//
+// O 3º harmônico do E grave (247,2 Hz) fica a 2 cents do B3 e não se separa dele em
+// um bloco; com as duas cordas soando, a leitura do B3 é puxada na direção desse harmônico.
+
+#define STRUM_STRINGS 6              // Máximo de cordas conferidas
+#define STRUM_HARMONICS 2            // Fundamental e 2º harmônico
+#define STRUM_DECIMATION 2           // Razão entre a taxa de entrada e a do banco
+#define STRUM_HISTORY 6              // Amostras anteriores guardadas pelo meia-banda
+#define STRUM_BLOCK 256              // Amostras do banco por estimativa (128 ms com entrada a 4 kHz)
+#define STRUM_MIN_LEVEL 10           // Amplitude mínima de um harmônico (contagens do ADC)
+#define STRUM_AGREEMENT FIXED_FROM_INT(5)  // Diferença máxima entre os harmônicos (cents)
+
+// Um ressonador de Goertzel e a fase medida no bloco anterior
+typedef struct {
+    int16_t coeff;          // 2 cos(w) em Q14 (= cos(w) em Q15)
+    int16_t sin_w;          // sen(w) em Q15, para a saída complexa
+    fixed_t freq;           // Frequência exata do ressonador, após quantizar coeff (Hz, Q16.16)
+    uint32_t hop_turns;     // Avanço de fase esperado em um bloco (voltas x 2^32)
+    int32_t s1, s2;         // Estado da recorrência
+    bool enabled;           // Harmônico abaixo de 1/3 da taxa do banco (senão, ignorado)
+    uint32_t angle;         // Fase da saída no bloco anterior
+    bool has_angle;         // angle vale como referência
+} strum_resonator_t;
+
+// Leitura de uma corda
+typedef struct {
+    uint8_t midi;           // Nota da corda solta
+    bool valid;             // Corda soando nos últimos blocos
+    fixed_t cents;          // Desvio em relação à nota (Q16.16, suavizado entre blocos)
+    uint16_t level;         // Amplitude do harmônico mais forte (contagens do ADC)
+} strum_string_t;
+
+typedef struct {
+    uint8_t count;          // Cordas conferidas
+    strum_string_t strings[STRUM_STRINGS];
+} strum_reading_t;
+
+typedef struct {
+    uint32_t bank_rate;     // Taxa do banco: taxa de entrada / STRUM_DECIMATION (Hz)
+    int32_t dc;             // Nível DC do microfone (Q8)
+    int32_t history[STRUM_HISTORY]; // Entradas anteriores do meia-banda (sem DC)
+    bool odd;               // Próxima entrada completa um par (gera uma saída)
+    uint32_t count;         // Amostras do bloco atual
+    uint32_t resonators_used; // Ressonadores atualizados (múltiplo de 4)
+    fixed_t target[STRUM_STRINGS];  // Frequência de cada corda (Hz, Q16.16)
+    strum_resonator_t resonators[STRUM_STRINGS * STRUM_HARMONICS];  // Corda i: [i * H + h]
+    strum_reading_t reading;
+} strum_t;
+
+extern const uint8_t strum_standard_tuning[STRUM_STRINGS];  // E2 A2 D3 G3 B3 E4
+
+// sample_rate deve ser par (o meia-banda divide a taxa por 2)
+void strum_init(strum_t *st, uint32_t sample_rate);
+
+// Define as notas das cordas soltas (MIDI, até STRUM_STRINGS) e recalcula os
+// ressonadores. Usa a referência A4 atual do note_map.
+void strum_set_strings(strum_t *st, const uint8_t *midi, uint8_t strings);
+
+// Processa amostras do ADC (12 bits) consecutivas; retorna true se algum bloco foi
+// concluído (leitura atualizada)
+bool strum_process(strum_t *st, const uint16_t *samples, uint32_t count);
+
+void strum_read(const strum_t *st, strum_reading_t *reading);
+
+#endif // STRUM_H
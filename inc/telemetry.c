@@ -0,0 +1,123 @@
+#include "telemetry.h"
+
+#if AFINADOR_TELEMETRY
+
+#include <stdio.h>
+#ifdef AFINADOR_HOST
+#include <time.h>
+#include "hal.h"
+#else
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+#endif
+
+telemetry_ring_t telemetry_rings[2];
+
+static const char *const stage_names[TELEMETRY_STAGES] = {
+    "capture", "amplitude", "pitch", "smoothing", "note", "strobe", "render", "flush", "leds"
+};
+
+// Acumulado de cada etapa desde o último quadro
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} stage_stats_t;
+
+static stage_stats_t stats[TELEMETRY_STAGES];
+static uint32_t last_frame_ms = 0;
+static bool muted = false;
+
+#ifdef AFINADOR_HOST
+#define TELEMETRY_CLOCK_HZ 1000000000u  // "Ciclos" em ns
+
+uint32_t telemetry_host_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return 0u - (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);  // Decrescente, como o SysTick
+}
+
+void telemetry_init_core(void) {
+}
+
+static uint32_t telemetry_ms(void) {
+    return (uint32_t)(hal_time_us() / 1000);
+}
+#else
+#define TELEMETRY_CLOCK_HZ clock_get_hz(clk_sys)
+
+void telemetry_init_core(void) {
+    systick_hw->csr = 0;
+    systick_hw->rvr = TELEMETRY_CYCLE_MASK;  // Período máximo: só a diferença importa
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5;                   // Habilitado, clock do processador, sem interrupção
+}
+
+static uint32_t telemetry_ms(void) {
+    return to_ms_since_boot(get_absolute_time());
+}
+#endif
+
+static void telemetry_reset(void) {
+    for (uint32_t i = 0; i < TELEMETRY_STAGES; i++) {
+        stats[i].count = 0;
+        stats[i].sum = 0;
+    }
+}
+
+void telemetry_mute(bool mute) {
+    muted = mute;
+    telemetry_reset();
+    last_frame_ms = telemetry_ms();  // Período recomeça: sem quadro logo na saída
+}
+
+static void telemetry_drain(telemetry_ring_t *ring) {
+    uint32_t tail = ring->tail;
+    uint32_t head = ring->head;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);  // Registros lidos depois do head
+    for (; tail != head; tail++) {
+        uint32_t record = ring->records[tail & (TELEMETRY_RING_SIZE - 1)];
+        uint32_t stage = record >> 24;
+        uint32_t cycles = record & TELEMETRY_CYCLE_MASK;
+        if (stage >= TELEMETRY_STAGES) continue;
+
+        stage_stats_t *s = &stats[stage];
+        if (s->count == 0 || cycles < s->min) s->min = cycles;
+        if (s->count == 0 || cycles > s->max) s->max = cycles;
+        s->sum += cycles;
+        s->count++;
+    }
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    ring->tail = tail;  // Libera as posições para o produtor
+}
+
+// Quadro CSV, em ciclos do clock do sistema:
+//   T,frame,<ms desde o boot>,<clk_sys em Hz>,<registros perdidos>
+//   T,<etapa>,<contagem>,<mínimo>,<média>,<máximo>   (uma linha por etapa medida)
+void telemetry_poll(void) {
+    telemetry_drain(&telemetry_rings[0]);
+    telemetry_drain(&telemetry_rings[1]);
+    if (muted) {
+        telemetry_reset();  // Os anéis não enchem, e nada da gravação vai para o quadro
+        return;
+    }
+
+    uint32_t now = telemetry_ms();
+    if (now - last_frame_ms < TELEMETRY_PERIOD_MS) return;
+    last_frame_ms = now;
+
+    printf("T,frame,%u,%u,%u\n", (unsigned)now, (unsigned)TELEMETRY_CLOCK_HZ,
+           (unsigned)(telemetry_rings[0].dropped + telemetry_rings[1].dropped));
+    for (uint32_t i = 0; i < TELEMETRY_STAGES; i++) {
+        stage_stats_t *s = &stats[i];
+        if (s->count == 0) continue;
+        printf("T,%s,%u,%u,%u,%u\n", stage_names[i], (unsigned)s->count, (unsigned)s->min,
+               (unsigned)(s->sum / s->count), (unsigned)s->max);
+        s->count = 0;
+        s->sum = 0;
+    }
+}
+
+#endif // AFINADOR_TELEMETRY
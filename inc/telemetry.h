@@ -0,0 +1,110 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Medição de ciclos por etapa do modo afinador.
+//
+// TELEMETRY_BEGIN(ETAPA) / TELEMETRY_END(ETAPA) leem o SysTick do núcleo que roda a
+// etapa (um contador decrescente de 24 bits no clock do sistema) e gravam um registro
+// de 32 bits (etapa nos 8 bits altos, ciclos nos 24 baixos) no anel desse núcleo.
+// Cada anel tem um único produtor; o núcleo 0 esvazia os dois em telemetry_poll() e,
+// a cada TELEMETRY_PERIOD_MS, envia pela serial um quadro CSV com contagem, mínimo,
+// média e máximo de cada etapa.
+//
+// A serial também leva os quadros binários do modo Gravar: durante a gravação
+// (telemetry_mute) os anéis continuam sendo esvaziados, mas nada é enviado nem acumulado.
+// No host (simulador, um núcleo) os ciclos são nanossegundos do relógio do Linux e o
+// quadro segue o relógio virtual da HAL.
+//
+// Sem AFINADOR_TELEMETRY (opção do CMake) as macros não geram código nenhum.
+
+#ifndef AFINADOR_TELEMETRY
+#define AFINADOR_TELEMETRY 0
+#endif
+
+typedef enum {
+    TELEMETRY_CAPTURE,      // Bloco do ADC (decimação incluída, com sobreamostragem)
+    TELEMETRY_AMPLITUDE,    // Nível do bloco (DC, RMS e porta de ruído)
+    TELEMETRY_PITCH,        // Detector de frequência (ou janela deslizante)
+    TELEMETRY_SMOOTHING,    // Acompanhamento da frequência (mediana e Kalman, tracker.h)
+    TELEMETRY_NOTE,         // Nota mais próxima
+    TELEMETRY_STROBE,       // Estrobo e banco das cordas
+    TELEMETRY_RENDER,       // Desenho da tela no framebuffer
+    TELEMETRY_FLUSH,        // Envio das janelas alteradas ao OLED (I2C)
+    TELEMETRY_LEDS,         // Matriz WS2812
+    TELEMETRY_STAGES
+} telemetry_stage_t;
+
+#if AFINADOR_TELEMETRY
+
+#define TELEMETRY_RING_SIZE 256      // Registros por núcleo (potência de 2)
+#define TELEMETRY_PERIOD_MS 1000     // Intervalo entre quadros enviados
+#define TELEMETRY_CYCLE_MASK 0xFFFFFFu
+
+#ifdef AFINADOR_HOST
+uint32_t telemetry_host_now(void);   // Contador decrescente em ns (telemetry.c)
+#define TELEMETRY_CPUID 0u
+#else
+// Lidos direto (SysTick do Cortex-M0+ e CPUID do SIO) para a biblioteca de DSP
+// continuar sem dependências do SDK
+#define TELEMETRY_SYST_CVR (*(volatile uint32_t *)0xE000E018u)
+#define TELEMETRY_CPUID (*(volatile uint32_t *)0xD0000000u)
+#endif
+
+typedef struct {
+    uint32_t records[TELEMETRY_RING_SIZE];
+    volatile uint32_t head;      // Escrito só pelo núcleo dono do anel
+    volatile uint32_t tail;      // Escrito só pelo núcleo 0, em telemetry_poll()
+    volatile uint32_t dropped;   // Registros perdidos com o anel cheio
+} telemetry_ring_t;
+
+extern telemetry_ring_t telemetry_rings[2];
+
+static inline uint32_t telemetry_now(void) {
+#ifdef AFINADOR_HOST
+    return telemetry_host_now();
+#else
+    return TELEMETRY_SYST_CVR;
+#endif
+}
+
+// Grava os ciclos desde `start`; etapas acima de 2^24 ciclos (131 ms a 128 MHz) dão a volta
+static inline void telemetry_record(telemetry_stage_t stage, uint32_t start) {
+    uint32_t cycles = (start - telemetry_now()) & TELEMETRY_CYCLE_MASK;  // O SysTick conta para baixo
+    telemetry_ring_t *ring = &telemetry_rings[TELEMETRY_CPUID & 1];
+    uint32_t head = ring->head;
+    if (head - ring->tail >= TELEMETRY_RING_SIZE) {
+        ring->dropped++;
+        return;
+    }
+    ring->records[head & (TELEMETRY_RING_SIZE - 1)] = ((uint32_t)stage << 24) | cycles;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);  // Registro visível antes do novo head
+    ring->head = head + 1;
+}
+
+// Liga o SysTick do núcleo que chama (cada núcleo tem o seu)
+void telemetry_init_core(void);
+
+// Esvazia os anéis e, a cada TELEMETRY_PERIOD_MS, envia o quadro (núcleo 0)
+void telemetry_poll(void);
+
+// Silencia os quadros enquanto a serial leva a gravação; ao voltar, o próximo quadro
+// só tem as medições feitas depois (núcleo 0)
+void telemetry_mute(bool mute);
+
+#define TELEMETRY_BEGIN(stage) uint32_t telemetry_start_##stage = telemetry_now()
+#define TELEMETRY_END(stage) telemetry_record(TELEMETRY_##stage, telemetry_start_##stage)
+
+#else
+
+#define TELEMETRY_BEGIN(stage) do { } while (0)
+#define TELEMETRY_END(stage) do { } while (0)
+#define telemetry_init_core() do { } while (0)
+#define telemetry_poll() do { } while (0)
+#define telemetry_mute(mute) do { } while (0)
+
+#endif // AFINADOR_TELEMETRY
+
+#endif // TELEMETRY_H
@@ -0,0 +1,187 @@
+#include "tone.h"
+#include <math.h>
+
+#ifndef AFINADOR_HOST
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/pwm.h"
+#endif
+
+#define SINE_BITS 8
+#define SINE_SIZE (1u << SINE_BITS)
+#define MAX_FRACTION 65535u          // Numerador e denominador do timer de DMA (16 bits)
+
+// Seno em Q15 (gerado uma única vez, como os twiddles da FFT)
+static int16_t sine[SINE_SIZE];
+static bool sine_ready = false;
+
+static void tone_build_sine(void) {
+    for (uint32_t k = 0; k < SINE_SIZE; k++) {
+        sine[k] = (int16_t)lrintf(sinf(6.28318530718f * (float)k / SINE_SIZE) * 32767.0f);
+    }
+    sine_ready = true;
+}
+
+// Frequência tocada com uma fração e uma tabela (Hz, Q16.16)
+static fixed_t tone_frequency(uint32_t clk_hz, uint32_t num, uint32_t den, uint32_t points, uint32_t cycles) {
+    uint64_t div = (uint64_t)den * points;
+    return (fixed_t)((((uint64_t)clk_hz * num * cycles << FIXED_SHIFT) + div / 2) / div);
+}
+
+// Melhor fração num / den (até MAX_FRACTION) para target / (clk x 2^16): convergentes
+// da fração contínua e, no último passo, o maior semiconvergente que ainda cabe
+static bool best_fraction(uint64_t target, uint64_t clock, uint32_t *num, uint32_t *den) {
+    uint64_t p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+    uint64_t n = target, d = clock;
+    while (d != 0) {
+        uint64_t a = n / d;
+        uint64_t p2 = p0 + a * p1, q2 = q0 + a * q1;
+        if (q2 > MAX_FRACTION || p2 > MAX_FRACTION) {
+            uint64_t t = (MAX_FRACTION - q0) / q1;
+            uint64_t tp = (p1 > 0) ? (MAX_FRACTION - p0) / p1 : t;
+            if (tp < t) t = tp;
+            // Semiconvergente (p0 + t p1) / (q0 + t q1): o chamador compara os dois pelo erro
+            if (t > 0 && p0 + t * p1 > 0) {
+                p0 += t * p1;
+                q0 += t * q1;
+            }
+            break;
+        }
+        p0 = p1;
+        q0 = q1;
+        p1 = p2;
+        q1 = q2;
+        uint64_t r = n - a * d;
+        n = d;
+        d = r;
+    }
+    if (p1 == 0 || q1 == 0) return false;
+    num[0] = (uint32_t)p1;
+    den[0] = (uint32_t)q1;
+    num[1] = (uint32_t)p0;
+    den[1] = (uint32_t)q0;
+    return true;
+}
+
+bool tone_plan(fixed_t frequency, uint32_t clk_hz, tone_plan_t *plan) {
+    if (frequency <= 0) return false;
+
+    // Cada combinação de tabela e períodos que respeita TONE_MAX_RATE e TONE_MIN_PERIOD
+    // rende duas frações candidatas; fica a de menor erro na frequência tocada
+    bool found = false;
+    int64_t best_error = 0;
+    for (uint32_t points = TONE_MIN_POINTS; points <= TONE_MAX_POINTS; points <<= 1) {
+        for (uint32_t cycles = 1; cycles * TONE_MIN_PERIOD <= points; cycles++) {
+            uint64_t rate = (uint64_t)frequency * points / cycles;  // Taxa do PWM (Hz, Q16.16)
+            if (rate > ((uint64_t)TONE_MAX_RATE << FIXED_SHIFT)) continue;
+
+            uint32_t num[2], den[2];
+            if (!best_fraction(rate, (uint64_t)clk_hz << FIXED_SHIFT, num, den)) continue;
+            for (int c = 0; c < 2; c++) {
+                if (num[c] == 0 || den[c] == 0 || num[c] > den[c]) continue;
+                fixed_t played = tone_frequency(clk_hz, num[c], den[c], points, cycles);
+                int64_t error = (played > frequency) ? played - frequency : frequency - played;
+                if (!found || error < best_error) {
+                    found = true;
+                    best_error = error;
+                    plan->points = (uint16_t)points;
+                    plan->cycles = (uint16_t)cycles;
+                    plan->num = (uint16_t)num[c];
+                    plan->den = (uint16_t)den[c];
+                    plan->frequency = played;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+void tone_render(const tone_plan_t *plan, uint16_t amplitude, uint16_t *table) {
+    if (!sine_ready) tone_build_sine();
+
+    // Acumulador de fase: `cycles` períodos exatos em `points` passos (points é
+    // potência de 2, então a palavra de sintonia é exata e a tabela fecha o anel)
+    uint32_t phase = 0;
+    uint32_t increment = (uint32_t)(((uint64_t)plan->cycles << 32) / plan->points);
+    for (uint32_t i = 0; i < plan->points; i++) {
+        int32_t s = sine[phase >> (32 - SINE_BITS)];
+        table[i] = (uint16_t)(amplitude + ((amplitude * s) >> 15));
+        phase += increment;
+    }
+}
+
+#ifndef AFINADOR_HOST
+
+// Tabela tocada pela DMA: alinhada ao próprio tamanho para o anel de leitura
+static uint16_t table[TONE_MAX_POINTS] __attribute__((aligned(TONE_MAX_POINTS * sizeof(uint16_t))));
+static uint32_t loop_count;              // Transferências por passada (múltiplo da tabela)
+static int data_chan = -1, control_chan = -1, pacing_timer = -1;
+static unsigned int tone_gpio;
+
+bool tone_start(unsigned int gpio, fixed_t frequency, uint16_t amplitude, tone_plan_t *plan) {
+    tone_stop();
+    if (!tone_plan(frequency, clock_get_hz(clk_sys), plan)) return false;
+    if (amplitude > TONE_PWM_WRAP / 2) amplitude = TONE_PWM_WRAP / 2;
+    tone_render(plan, amplitude, table);
+
+    // PWM sem divisor: cada nível vale a partir do próximo ciclo da portadora
+    tone_gpio = gpio;
+    gpio_set_function(gpio, GPIO_FUNC_PWM);
+    uint slice = pwm_gpio_to_slice_num(gpio);
+    pwm_set_clkdiv_int_frac(slice, 1, 0);
+    pwm_set_wrap(slice, TONE_PWM_WRAP);
+    pwm_set_chan_level(slice, pwm_gpio_to_channel(gpio), table[0]);
+    pwm_set_enabled(slice, true);
+
+    pacing_timer = dma_claim_unused_timer(true);
+    dma_timer_set_fraction((uint)pacing_timer, plan->num, plan->den);
+    data_chan = dma_claim_unused_channel(true);
+    control_chan = dma_claim_unused_channel(true);
+
+    // Canal de dados: tabela em anel -> comparador do PWM. Escritas de 16 bits são
+    // replicadas nas duas metades de CC, então vale para o canal A ou B do pino.
+    uint ring_bits = 1;
+    while ((1u << ring_bits) < plan->points * sizeof(uint16_t)) ring_bits++;
+    loop_count = plan->points * 128u;
+    dma_channel_config data = dma_channel_get_default_config((uint)data_chan);
+    channel_config_set_transfer_data_size(&data, DMA_SIZE_16);
+    channel_config_set_read_increment(&data, true);
+    channel_config_set_write_increment(&data, false);
+    channel_config_set_ring(&data, false, ring_bits);
+    channel_config_set_dreq(&data, dma_get_timer_dreq((uint)pacing_timer));
+    channel_config_set_chain_to(&data, (uint)control_chan);
+    dma_channel_configure((uint)data_chan, &data, &pwm_hw->slice[slice].cc, table, loop_count, false);
+
+    // Canal de controle: ao fim de cada passada, regrava a contagem no alias que
+    // redispara o canal de dados (o anel mantém a fase da tabela)
+    dma_channel_config control = dma_channel_get_default_config((uint)control_chan);
+    channel_config_set_transfer_data_size(&control, DMA_SIZE_32);
+    channel_config_set_read_increment(&control, false);
+    channel_config_set_write_increment(&control, false);
+    dma_channel_configure((uint)control_chan, &control,
+                          &dma_channel_hw_addr((uint)data_chan)->al1_transfer_count_trig,
+                          &loop_count, 1, false);
+
+    dma_channel_start((uint)data_chan);
+    return true;
+}
+
+void tone_stop(void) {
+    if (data_chan < 0) return;
+
+    // O controle primeiro, para não redisparar o canal de dados durante o abort
+    dma_channel_abort((uint)control_chan);
+    dma_channel_abort((uint)data_chan);
+    dma_channel_abort((uint)control_chan);
+    dma_channel_unclaim((uint)data_chan);
+    dma_channel_unclaim((uint)control_chan);
+    dma_timer_unclaim((uint)pacing_timer);
+    data_chan = control_chan = pacing_timer = -1;
+
+    uint slice = pwm_gpio_to_slice_num(tone_gpio);
+    pwm_set_chan_level(slice, pwm_gpio_to_channel(tone_gpio), 0);
+    pwm_set_enabled(slice, false);
+}
+
+#endif // AFINADOR_HOST
@@ -0,0 +1,52 @@
+#ifndef TONE_H
+#define TONE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixed.h"
+
+// Gerador de tom de referência por síntese digital direta (DDS).
+//
+// Um acumulador de fase de 32 bits, com palavra de sintonia cycles x 2^32 / points,
+// percorre uma tabela de seno e gera `cycles` períodos exatos do tom em `points`
+// níveis de PWM. A DMA toca essa tabela em anel, escrevendo cada nível no
+// comparador do PWM, cadenciada por um timer de DMA a clk_sys x num / den.
+// A frequência tocada é
+//
+//     clk_sys x num x cycles / (den x points)
+//
+// e num / den é a melhor fração (16 bits) para cada combinação de tabela; a
+// liberdade extra de `cycles` deixa o erro abaixo de 1 mHz em toda a tabela de
+// notas. Durante a reprodução a CPU não participa: um segundo canal de DMA rearma
+// o primeiro ao fim de cada passada.
+
+#define TONE_MAX_POINTS 8192         // Pontos da tabela (potência de 2, 16 KB em RAM)
+#define TONE_MIN_POINTS 16
+#define TONE_MIN_PERIOD 16           // Menos níveis por período do tom
+#define TONE_MAX_RATE 100000         // Maior taxa de atualização do PWM (Hz)
+#define TONE_PWM_WRAP 255            // PWM de 8 bits: portadora de clk_sys / 256 (500 kHz a 128 MHz)
+#define TONE_DEFAULT_AMPLITUDE 16    // Amplitude do seno em níveis de PWM (volume baixo)
+
+// Parâmetros calculados para uma frequência
+typedef struct {
+    uint16_t points;        // Níveis na tabela (potência de 2)
+    uint16_t cycles;        // Períodos do tom na tabela
+    uint16_t num, den;      // Fração do timer de DMA: taxa = clk_sys x num / den
+    fixed_t frequency;      // Frequência efetivamente tocada (Hz, Q16.16)
+} tone_plan_t;
+
+// Escolhe tabela, períodos e fração para tocar `frequency` (Hz, Q16.16) com o clock
+// `clk_hz`. Percorre ~1000 combinações: roda só quando a nota muda, nunca no laço.
+// Retorna false se a frequência estiver fora do alcance do timer.
+bool tone_plan(fixed_t frequency, uint32_t clk_hz, tone_plan_t *plan);
+
+// Gera a tabela em níveis de PWM: amplitude x (1 + sen), entre 0 e 2 x amplitude
+void tone_render(const tone_plan_t *plan, uint16_t amplitude, uint16_t *table);
+
+// Backend de hardware: PWM do pino, timer de DMA e dois canais de DMA. Lê o clock
+// real com clock_get_hz(clk_sys). tone_start substitui o tom em andamento.
+// No host, o simulador (host/hal_host.c) só planeja o tom e registra o evento.
+bool tone_start(unsigned int gpio, fixed_t frequency, uint16_t amplitude, tone_plan_t *plan);
+void tone_stop(void);
+
+#endif // TONE_H
@@ -0,0 +1,109 @@
+#include "tracker.h"
+#include "note_map.h"
+
+#define Q30_ONE (1 << 30)
+#define LN2_PER_CENT_Q30 620214     // ln(2) / 1200 em Q30
+
+static int32_t mul_q30(int32_t a, int32_t b) {
+    return (int32_t)(((int64_t)a * b) >> 30);
+}
+
+void tracker_init(tracker_t *tr, uint32_t sample_rate) {
+    tr->sample_rate = sample_rate;
+    tracker_reset(tr);
+}
+
+void tracker_reset(tracker_t *tr) {
+    tr->count = 0;
+    tr->next = 0;
+    tr->locked = false;
+    tr->pitch = 0;
+    tr->variance = 0;
+    tr->idle = 0;
+}
+
+bool tracker_cents(fixed_t frequency, fixed_t *pitch) {
+    note_info_t note;
+    if (!note_map_lookup(frequency, &note)) return false;
+    *pitch = FIXED_FROM_INT(100 * (int32_t)note.midi) + note.cents;
+    return true;
+}
+
+// Frequência da nota mais próxima vezes 2^(c / 1200), com |c| pouco acima de 50
+// cents: e^x ~ 1 + x + x^2 / 2 + x^3 / 6 (erro < 0,01 cent)
+fixed_t tracker_frequency(fixed_t pitch) {
+    int32_t midi = (pitch + FIXED_FROM_INT(50)) / FIXED_FROM_INT(100);
+    if (midi < NOTE_MAP_MIN_MIDI) midi = NOTE_MAP_MIN_MIDI;
+    if (midi > NOTE_MAP_MAX_MIDI) midi = NOTE_MAP_MAX_MIDI;
+    fixed_t cents = pitch - FIXED_FROM_INT(100 * midi);
+
+    int32_t x = (int32_t)(((int64_t)cents * LN2_PER_CENT_Q30) >> FIXED_SHIFT);
+    int32_t t = Q30_ONE / 2 + mul_q30(x, Q30_ONE / 6);
+    t = Q30_ONE + mul_q30(x, t);
+    int32_t ratio = Q30_ONE + mul_q30(x, t);
+    return (fixed_t)(((int64_t)note_map_frequency((uint8_t)midi) * ratio + (1 << 29)) >> 30);
+}
+
+// Posição da mediana das três estimativas
+static uint8_t median3(const fixed_t *v) {
+    if ((v[0] <= v[1]) == (v[1] <= v[2])) return 1;
+    if ((v[1] <= v[0]) == (v[0] <= v[2])) return 0;
+    return 2;
+}
+
+fixed_t tracker_update(tracker_t *tr, fixed_t frequency, q15_t clarity, uint32_t samples) {
+    tr->idle += samples;
+    fixed_t measured;
+    if (frequency <= 0 || clarity <= 0 || !tracker_cents(frequency, &measured)) {
+        if (tr->locked && tr->idle >= tr->sample_rate * TRACKER_RELEASE_MS / 1000) tracker_reset(tr);
+        return tr->locked ? tracker_frequency(tr->pitch) : 0;
+    }
+
+    uint32_t elapsed = tr->idle;  // Amostras desde a última estimativa aceita
+    tr->idle = 0;
+
+    // Variância da medida, proporcional a 1 - clareza (a parte da energia da janela
+    // que não se repete no período), com um mínimo
+    int32_t unclear = Q15_ONE - clarity;
+    fixed_t noise = (fixed_t)((int64_t)FIXED_FROM_INT(TRACKER_NOISE_CENTS * TRACKER_NOISE_CENTS) * unclear /
+                              (Q15_ONE - TRACKER_NOISE_CLARITY));
+    if (noise < TRACKER_MIN_NOISE) noise = TRACKER_MIN_NOISE;
+
+    tr->history[tr->next] = measured;
+    tr->noise[tr->next] = noise;
+    tr->next = (uint8_t)((tr->next + 1) % TRACKER_MEDIAN);
+    if (tr->count < TRACKER_MEDIAN) tr->count++;
+
+    if (!tr->locked) {
+        // Primeira estimativa da nota: trava direto nela
+        tr->locked = true;
+        tr->pitch = measured;
+        tr->variance = FIXED_FROM_INT(TRACKER_LOCK_CENTS * TRACKER_LOCK_CENTS);
+        return tracker_frequency(tr->pitch);
+    }
+
+    // Mediana de três, que entra no filtro com a variância da sua própria estimativa.
+    // Com só duas, a nova vale se concordar com a primeira; senão fica o estado, até a
+    // terceira desempatar.
+    fixed_t median = tr->pitch;
+    if (tr->count == TRACKER_MEDIAN) {
+        uint8_t m = median3(tr->history);
+        median = tr->history[m];
+        noise = tr->noise[m];
+    } else if (fixed_abs(measured - tr->history[0]) <= FIXED_FROM_INT(TRACKER_SNAP_CENTS)) {
+        median = measured;
+    }
+
+    if (fixed_abs(median - tr->pitch) > FIXED_FROM_INT(TRACKER_SNAP_CENTS)) {
+        // Troca de nota: salta em vez de deslizar pelas notas do meio
+        tr->pitch = median;
+        tr->variance = FIXED_FROM_INT(TRACKER_LOCK_CENTS * TRACKER_LOCK_CENTS);
+    } else {
+        // Predição (a corda pode ter derivado desde a última estimativa) e correção
+        int64_t prior = tr->variance + (int64_t)FIXED_FROM_INT(TRACKER_DRIFT_CENTS2) * elapsed / tr->sample_rate;
+        int64_t gain = (prior << FIXED_SHIFT) / (prior + noise);  // Q16, 0 a 1
+        tr->pitch += (fixed_t)(((int64_t)(median - tr->pitch) * gain) >> FIXED_SHIFT);
+        tr->variance = (fixed_t)(prior - ((prior * gain) >> FIXED_SHIFT));
+    }
+    return tracker_frequency(tr->pitch);
+}
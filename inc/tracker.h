@@ -0,0 +1,59 @@
+#ifndef TRACKER_H
+#define TRACKER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixed.h"
+
+// Acompanhamento da altura entre estimativas do detector, em cents absolutos
+// (100 x MIDI + desvio, relativo à tabela de note_map.h): a mesma distância em
+// cents vale o mesmo em qualquer corda, o que uma média em Hz não garante.
+//
+// Cada estimativa passa por uma mediana de três (a nova e as duas anteriores), que
+// descarta um salto de oitava isolado, e alimenta um filtro de Kalman de um estado.
+// A variância da medida cresce com 1 - clareza do detector (janelas que ainda
+// misturam o ataque ou o ruído pesam menos), e a do processo cresce com o tempo
+// desde a última estimativa: com saltos curtos o filtro suaviza mais por estimativa,
+// com blocos longos confia mais em cada uma.
+//
+// A primeira estimativa trava o filtro direto nela; se a mediana se afasta mais de
+// TRACKER_SNAP_CENTS do estado (duas estimativas seguidas em outra nota), o filtro
+// salta para ela em vez de deslizar. Sem estimativas por TRACKER_RELEASE_MS, a nota
+// é solta e a próxima recomeça do zero.
+
+#define TRACKER_MEDIAN 3            // Estimativas na mediana
+#define TRACKER_NOISE_CENTS 2       // Desvio padrão de uma estimativa com clareza TRACKER_NOISE_CLARITY (cents)
+#define TRACKER_NOISE_CLARITY Q15_CONST(0.9)
+#define TRACKER_MIN_NOISE FIXED_CONST(0.25) // Menor variância de uma estimativa (cents^2)
+#define TRACKER_DRIFT_CENTS2 10     // Variância da deriva da corda por segundo (cents^2/s)
+#define TRACKER_LOCK_CENTS 10       // Desvio padrão do estado ao travar (a janela ainda mistura o ataque)
+#define TRACKER_SNAP_CENTS 50       // Distância que conta como troca de nota (cents)
+#define TRACKER_RELEASE_MS 250      // Tempo sem estimativa até soltar a nota
+
+typedef struct {
+    uint32_t sample_rate;           // Taxa das amostras analisadas (Hz)
+    fixed_t history[TRACKER_MEDIAN]; // Últimas estimativas (cents absolutos, Q16.16)
+    fixed_t noise[TRACKER_MEDIAN];  // Variância de cada uma (cents^2, Q16.16)
+    uint8_t count;                  // Estimativas em history (satura em TRACKER_MEDIAN)
+    uint8_t next;                   // Posição da próxima estimativa em history
+    bool locked;                    // Há uma nota travada
+    fixed_t pitch;                  // Estado do filtro (cents absolutos, Q16.16)
+    fixed_t variance;               // Variância do estado (cents^2, Q16.16)
+    uint32_t idle;                  // Amostras desde a última estimativa aceita
+} tracker_t;
+
+void tracker_init(tracker_t *tr, uint32_t sample_rate);
+
+// Solta a nota (troca de perfil ou de referência A4)
+void tracker_reset(tracker_t *tr);
+
+// Entrega uma estimativa (frequency = 0: bloco sem estimativa) após `samples`
+// amostras desde a chamada anterior. Retorna a frequência acompanhada (Hz, Q16.16),
+// ou 0 sem nota travada.
+fixed_t tracker_update(tracker_t *tr, fixed_t frequency, q15_t clarity, uint32_t samples);
+
+// Conversões entre frequência e cents absolutos pela tabela de notas (B0..C7)
+bool tracker_cents(fixed_t frequency, fixed_t *pitch);
+fixed_t tracker_frequency(fixed_t pitch);
+
+#endif // TRACKER_H
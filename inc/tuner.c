@@ -0,0 +1,66 @@
+#include "tuner.h"
+#include "pitch.h"
+#include "fft.h"
+#include <stddef.h>
+
+#define OCTAVE_TOLERANCE FIXED_CONST(0.06)  // Desvio aceito na razão entre MPM e HPS, por harmônico
+#define OCTAVE_MIN_RATIO 6  // A fundamental suposta deve ter ao menos 1/6 (-15,6 dB) do módulo em f
+
+q15_t detected_clarity = 0;     // Confiança da última estimativa (Q15, 0 a 1)
+
+static fft_plan_t fft_plan;     // Plano da FFT usada pelo produto harmônico
+static const tuning_profile_t *profile = NULL;  // Perfil ativo (NULL = cromático)
+static uint32_t min_freq = MIN_DETECT_FREQ;     // Faixa procurada pelo detector (Hz)
+static uint32_t max_freq = MAX_DETECT_FREQ;
+
+// Prepara as tabelas da FFT (twiddles e reversão de bits) para o tamanho do bloco
+void tuner_init(uint32_t buffer_size) {
+    fft_plan.size = 0;
+    fft_plan_init(&fft_plan, (uint16_t)buffer_size);
+}
+
+void tuner_set_profile(const tuning_profile_t *new_profile) {
+    profile = new_profile;
+    min_freq = profile ? profile->min_freq : MIN_DETECT_FREQ;
+    max_freq = profile ? profile->max_freq : MAX_DETECT_FREQ;
+}
+
+// Função para calcular a frequência do sinal capturado (já sem DC)
+fixed_t calculate_frequency(const int16_t *buffer, uint32_t buffer_size, uint32_t sample_rate) {
+    pitch_result_t result;
+
+    // Detector McLeod (NSDF) com interpolação parabólica do período
+    bool found = pitch_detect(buffer, buffer_size, sample_rate, min_freq, max_freq, &result);
+    detected_clarity = result.clarity;
+
+    if (!found) return 0;  // Sem período claro: não há nota detectada
+
+    // Confere a oitava pelo produto harmônico: em cordas graves a fundamental pode
+    // ser mais fraca que o 2º e o 3º harmônicos, e o detector pode saltar de oitava.
+    // Só o HPS não basta: num tom puro, com os harmônicos no nível do ruído, o produto
+    // em f/h também pode vencer. A dobra exige que o próprio espectro tenha energia em
+    // f/h: o vazamento de um tom puro em f fica abaixo de 1/6 do pico a 2 bins ou mais.
+    fixed_t frequency = result.frequency;
+    if (fft_plan.size == buffer_size) {
+        fixed_t hps_freq = fft_detect_fundamental(&fft_plan, buffer, sample_rate, min_freq, max_freq);
+        if (hps_freq > 0) {
+            fixed_t ratio = fixed_div(frequency, hps_freq);
+            uint32_t level = fft_spectrum_level(&fft_plan, frequency, sample_rate);
+            for (uint8_t h = 2; h <= FFT_HPS_HARMONICS; h++) {
+                if (fixed_abs(ratio - FIXED_FROM_INT(h)) >= OCTAVE_TOLERANCE * h) continue;
+                uint32_t below = fft_spectrum_level(&fft_plan, frequency / h, sample_rate);
+                if (below * OCTAVE_MIN_RATIO >= level) frequency /= h;
+                break;
+            }
+        }
+    }
+
+    return frequency * CALIBRATION_FACTOR;  // Aplica o fator de calibração
+}
+
+// Função para determinar a nota mais próxima da frequência detectada: a corda mais
+// próxima do perfil ativo ou, sem perfil, a nota cromática
+bool get_closest_note(fixed_t frequency, note_info_t *note) {
+    if (profile) return profile_closest_note(profile, frequency, note);
+    return note_map_lookup(frequency, note);  // Tabela fixa: sem pow() nem dobras de oitava
+}
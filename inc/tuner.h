@@ -0,0 +1,28 @@
+#ifndef TUNER_H
+#define TUNER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "note_map.h"
+#include "profiles.h"
+
+// Rotinas de processamento do afinador (C puro, compiladas também no host). O
+// acompanhamento da frequência entre blocos fica em tracker.h.
+
+#define CALIBRATION_FACTOR 1    // Fator de calibração para a frequência
+#define MIN_DETECT_FREQ 40      // Menor frequência procurada sem perfil (Hz)
+#define MAX_DETECT_FREQ 1000    // Maior frequência procurada sem perfil (Hz)
+
+extern q15_t detected_clarity;          // Confiança da última estimativa (Q15, 0 a 1)
+
+// Frequências em Hz no formato Q16.16; fatores em Q15 (fixed.h)
+void tuner_init(uint32_t buffer_size);
+
+// Faixa do detector e alvos de get_closest_note() (NULL = cromático de
+// MIN_DETECT_FREQ a MAX_DETECT_FREQ)
+void tuner_set_profile(const tuning_profile_t *profile);
+// O bloco chega sem DC; o nível do sinal e a porta de ruído ficam em level.h
+fixed_t calculate_frequency(const int16_t *buffer, uint32_t buffer_size, uint32_t sample_rate);
+bool get_closest_note(fixed_t frequency, note_info_t *note);
+
+#endif // TUNER_H
@@ -1,19 +1,47 @@
 #include "ws2812.h"
+#include <string.h>
+
+#ifndef AFINADOR_HOST
 #include "ws2812.pio.h"
+#include "hardware/dma.h"
+#endif
 
 // Pino que realizará a comunicação do microcontrolador com a matriz
 #define OUT_PIN 7
 
-// Funções para matriz de LEDs
-uint32_t generateColorBinary(double red, double green, double blue)
-{
-    unsigned char RED, GREEN, BLUE;
-    RED = red * 255.0;
-    GREEN = green * 255.0;
-    BLUE = blue * 255.0;
-    return (GREEN << 24) | (RED << 16) | (BLUE << 8);
+#ifndef AFINADOR_HOST
+// Estado do driver: uma única matriz por placa
+static PIO ws2812Pio;
+static uint ws2812Sm;
+static int ws2812Dma = -1;
+#endif
+
+// Posição de cada LED na cadeia, calculada uma vez em ws2812Init
+static uint16_t chainIndex[WS2812_ROWS][WS2812_COLS];
+
+// Quadro GRB já na ordem da cadeia; é lido pela DMA enquanto a transferência está ativa
+static uint32_t frame[WS2812_PIXELS];
+static uint32_t staging[WS2812_PIXELS];
+static bool frameValid = false;
+
+// Instante a partir do qual o próximo quadro pode começar (fim da transmissão + reset)
+static uint64_t latchUntil;
+
+// A cadeia começa na última linha e alterna o sentido a cada linha (serpentina):
+// a primeira linha percorrida vai da direita para a esquerda.
+static void buildChainIndex(void) {
+    uint16_t position = 0;
+    for (int row = WS2812_ROWS - 1; row >= 0; row--) {
+        bool leftToRight = ((WS2812_ROWS - 1 - row) & 1) != 0;
+        for (int i = 0; i < WS2812_COLS; i++) {
+            int col = leftToRight ? i : WS2812_COLS - 1 - i;
+            chainIndex[row][col] = position++;
+        }
+    }
 }
 
+#ifndef AFINADOR_HOST
+
 uint ws2812Init(PIO pio) {
     bool ok;
 
@@ -25,39 +53,96 @@ uint ws2812Init(PIO pio) {
     uint sm = pio_claim_unused_sm(pio, true);
     ws2812ProgramInit(pio, sm, offset, OUT_PIN);
 
+    // DMA de 32 bits para o FIFO TX, no ritmo da DREQ da máquina de estado
+    ws2812Pio = pio;
+    ws2812Sm = sm;
+    ws2812Dma = dma_claim_unused_channel(true);
+    dma_channel_config config = dma_channel_get_default_config(ws2812Dma);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, pio_get_dreq(pio, sm, true));
+    dma_channel_configure(ws2812Dma, &config, &pio->txf[sm], frame, WS2812_PIXELS, false);
+
+    buildChainIndex();
+    frameValid = false;
+    latchUntil = hal_time_us();
+
     return sm;
 }
 
-void displayPattern(LedMatrix pattern, PIO pio, uint sm) {
-    for (int row = 4; row >= 0; row--) {
-        if (row % 2) {
-            for (int col = 0; col < 5; col++) {
-                uint32_t colorBinary = generateColorBinary(
-                    pattern[row][col].red,
-                    pattern[row][col].green,
-                    pattern[row][col].blue
-                );
-                pio_sm_put_blocking(pio, sm, colorBinary);
-            }
-        } else {
-            for (int col = 4; col >= 0; col--) {
-                uint32_t colorBinary = generateColorBinary(
-                    pattern[row][col].red,
-                    pattern[row][col].green,
-                    pattern[row][col].blue
-                );
-                pio_sm_put_blocking(pio, sm, colorBinary);
-            }
+// Transmissão em andamento (DMA ativa ou reset ainda não decorrido)
+bool ws2812Busy(void) {
+    return dma_channel_is_busy(ws2812Dma) || hal_time_us() < latchUntil;
+}
+
+// Dispara a DMA do quadro já copiado para `frame`
+static void ws2812Transmit(void) {
+    dma_channel_transfer_from_buffer_now(ws2812Dma, frame, WS2812_PIXELS);
+}
+
+// A DMA ainda lê o quadro anterior; a PIO precisa do tempo de reset para travar as cores
+static void ws2812WaitIdle(void) {
+    dma_channel_wait_for_finish_blocking(ws2812Dma);
+    hal_busy_wait_until_us(latchUntil);
+}
+
+#else // AFINADOR_HOST
+
+// No host a matriz é virtual: o quadro vai para o simulador, que devolve o fim da
+// transmissão modelada (WS2812_PIXEL_US por LED mais o reset)
+uint ws2812Init(PIO pio) {
+    (void)pio;
+    buildChainIndex();
+    frameValid = false;
+    latchUntil = hal_time_us();
+    return 0;
+}
+
+bool ws2812Busy(void) {
+    return hal_time_us() < latchUntil;
+}
+
+static void ws2812Transmit(void) {
+    latchUntil = hal_sim_leds_transfer(frame, WS2812_PIXELS);
+}
+
+static void ws2812WaitIdle(void) {
+    hal_busy_wait_until_us(latchUntil);
+}
+
+#endif // AFINADOR_HOST
+
+// Força o reenvio do próximo quadro, mesmo que seja igual ao atual
+void ws2812Invalidate(void) {
+    frameValid = false;
+}
+
+// Empacota o padrão e o envia por DMA. Quadros iguais ao último enviado são ignorados.
+// Retorna true se um novo quadro foi disparado. Só bloqueia se o quadro anterior
+// ainda estiver sendo transmitido (no máximo WS2812_PIXELS * 30 us + reset).
+bool displayPattern(LedMatrix pattern) {
+    for (int row = 0; row < WS2812_ROWS; row++) {
+        for (int col = 0; col < WS2812_COLS; col++) {
+            const LedConfig *led = &pattern[row][col];
+            staging[chainIndex[row][col]] = generateColorBinary(led->red, led->green, led->blue);
         }
     }
+
+    if (frameValid && memcmp(staging, frame, sizeof(frame)) == 0) {
+        return false;
+    }
+
+    ws2812WaitIdle();
+
+    memcpy(frame, staging, sizeof(frame));
+    frameValid = true;
+    latchUntil = hal_time_us() + WS2812_PIXELS * WS2812_PIXEL_US + WS2812_RESET_US;
+    ws2812Transmit();
+    return true;
 }
+
 void clearLedMatrix(LedMatrix matrix) {
-    // Percorrer a matriz e configurar todos os LEDs como apagados
-    for (int row = 0; row < 5; row++) {
-        for (int col = 0; col < 5; col++) {
-            matrix[row][col].red = 0.0;
-            matrix[row][col].green = 0.0;
-            matrix[row][col].blue = 0.0;
-        }
-    }
-}
\ No newline at end of file
+    // Configura todos os LEDs como apagados
+    memset(matrix, 0, sizeof(LedMatrix));
+}
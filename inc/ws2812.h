@@ -3,26 +3,48 @@
 
 #include <stdint.h>  // Para tipos como uint32_t, uint8_t, etc.
 #include <stdbool.h> // Para o tipo bool
-#include "pico/stdlib.h" // Para funções como sleep_ms, set_sys_clock_khz, etc.
+#include "hal.h"     // Tempo e, no host, os tipos do SDK e a matriz virtual
+#ifndef AFINADOR_HOST
 #include "hardware/pio.h" // Para funções e tipos relacionados ao PIO
 #include "hardware/clocks.h" // Inclui a função clock_get_hz
+#endif
 
-// Definição de tipo da estrutura que irá controlar a cor dos LED's
+// Dimensões da matriz (podem ser redefinidas na compilação para matrizes maiores)
+#ifndef WS2812_ROWS
+#define WS2812_ROWS 5
+#endif
+#ifndef WS2812_COLS
+#define WS2812_COLS 5
+#endif
+#define WS2812_PIXELS (WS2812_ROWS * WS2812_COLS)
+
+// Tempo de reset (latch) entre quadros: 50 us no WS2812, 280 us no WS2812B
+#define WS2812_RESET_US 300
+// Tempo de transmissão de um LED: 24 bits a 800 kHz
+#define WS2812_PIXEL_US 30
+
+// Definição de tipo da estrutura que irá controlar a cor dos LED's (0 a 255 por canal)
 typedef struct {
-    double red;
-    double green;
-    double blue;
+    uint8_t red;
+    uint8_t green;
+    uint8_t blue;
 } LedConfig;
 
 typedef LedConfig RGB;
 
 // Definição de tipo da matriz de LEDs
-typedef LedConfig LedMatrix[5][5];
+typedef LedConfig LedMatrix[WS2812_ROWS][WS2812_COLS];
+
+// Converte uma cor para a palavra GRB enviada à PIO (24 bits alinhados à esquerda)
+static inline uint32_t generateColorBinary(uint8_t red, uint8_t green, uint8_t blue) {
+    return ((uint32_t)green << 24) | ((uint32_t)red << 16) | ((uint32_t)blue << 8);
+}
 
 // Declarações das funções
-uint32_t generateColorBinary(double red, double green, double blue);
 uint ws2812Init(PIO pio);
-void displayPattern(LedMatrix pattern, PIO pio, uint sm);
+bool displayPattern(LedMatrix pattern);
+bool ws2812Busy(void);
+void ws2812Invalidate(void);
 void clearLedMatrix(LedMatrix ledMatrix);
 
-#endif // WS2812_H
\ No newline at end of file
+#endif // WS2812_H
@@ -1,17 +1,39 @@
-// Inclui as bibliotecas necessárias
-#include "pico/stdlib.h"
-#include "hardware/pwm.h"
-#include "hardware/gpio.h"
-#include "hardware/adc.h"
+// Inclui as bibliotecas necessárias (o acesso ao hardware passa pela HAL, que no host
+// é o simulador)
+#include "inc/hal.h"
 #include "inc/ssd1306.h"
 #include "inc/ws2812.h"
 #include "inc/notes.h"
+#include "inc/capture.h"
+#include "inc/tuner.h"
+#include "inc/analysis.h"
+#include "inc/decimator.h"
+#include "inc/fixed.h"
+#include "inc/profiles.h"
+#include "inc/tone.h"
+#include "inc/telemetry.h"
+#include "inc/record.h"
+#include "inc/buttons.h"
 #include <stdio.h>
 #include <string.h>
-#include <math.h>
+
+// Com AFINADOR_MULTICORE, o núcleo 1 captura e analisa o áudio e o núcleo 0 cuida
+// da interface; sem ela, tudo roda no mesmo laço (opção do CMake).
+#ifndef AFINADOR_MULTICORE
+#define AFINADOR_MULTICORE 0
+#endif
+
+#if AFINADOR_MULTICORE
+#include "pico/multicore.h"
+#endif
+
+// Com AFINADOR_STREAMING, a captura entrega blocos de um salto (CAPTURE_BLOCK_SIZE) e a
+// frequência vem de uma janela deslizante de ANALYSIS_WINDOW amostras (opção do CMake).
+#ifndef AFINADOR_STREAMING
+#define AFINADOR_STREAMING 0
+#endif
 
 // Definições de hardware e constantes
-#define DEBOUNCE_TIME_MS 250  // Tempo de debounce para os botões
 #define BUTTON_A_PIN 5        // Pino do botão A
 #define BUTTON_B_PIN 6        // Pino do botão B
 #define JOYSTICK_BUTTON_PIN 22 // Pino do botão do joystick
@@ -27,248 +49,821 @@
 
 PIO pio = pio0;  // Use pio0 ou pio1, dependendo do seu setup
 uint sm = 0;     // Variável para a máquina de estados
-absolute_time_t last_press_time_A = {0};     // Último tempo de pressionamento do botão A
-absolute_time_t last_press_time_B = {0};     // Último tempo de pressionamento do botão B
-absolute_time_t last_press_time_JOY = {0};   // Último tempo de pressionamento do botão do joystick
-const char *note_names[] = {"C", "D", "E", "F", "G", "A", "B"}; // Nomes das notas (apenas notas naturais)
-int8_t semitones_from_A4[] = {-9, -7, -5, -4, -2, 0, 2}; // Número de semitons em relação a A para cada nota natural (C, D, E, F, G, A, B)
-uint8_t selected_note_index = false;         // Índice da nota selecionada
+buttons_t buttons;    // Bordas vindas da interrupção e eventos já filtrados para o laço
+uint8_t selected_note_index = 0;  // Índice da nota selecionada (alterado pelos botões)
+#define MENU_OPTIONS 6        // Afinador, diapasão, estrobo, cordas, perfil e gravação
+uint8_t browsed_profile = PROFILE_CHROMATIC;           // Perfil mostrado na tela de perfis
+volatile uint8_t selected_profile = PROFILE_CHROMATIC; // Perfil confirmado (lido pela análise)
+uint8_t applied_profile = 0xFF;                         // Perfil em uso pela análise
+uint8_t diapason_index = 0;             // Nota tocada no diapasão (alterada pelos botões)
+volatile uint8_t reference_index = 0;   // Referência A4 escolhida no diapasão (lida pela análise)
+uint8_t applied_reference = 0xFF;       // Referência em uso pela análise
+tuning_profile_t custom_profile;        // Perfil personalizado editado pelo console (núcleo 0)
+volatile uint32_t custom_seq = 0;       // Ímpar enquanto o núcleo 0 escreve custom_profile
+uint32_t applied_custom = 0;            // Versão do perfil personalizado em uso pela análise
+volatile uint8_t analysis_stages = 0;   // Etapas opcionais do modo ativo (lidas pela análise)
 
 // Variáveis para o afinador
-#define SAMPLE_RATE 4000        // Taxa de amostragem (4 kHz)
-#define BUFFER_SIZE 512         // Tamanho do buffer para armazenar amostras
-#define FREQ_TOLERANCE 6        // Tolerância para considerar a nota afinada (em Hz)
-#define VOLUME_THRESHOLD 150    // Limiar de volume para detecção de som
-#define SMOOTHING_FACTOR 0.1    // Fator de suavização para a frequência detectada
-#define CALIBRATION_FACTOR 1    // Fator de calibração para a frequência
-float detected_freq = 0.0;      // Frequência detectada pelo microfone
+#define SAMPLE_RATE 4000        // Taxa de amostragem entregue ao detector (4 kHz)
+#ifndef OVERSAMPLING
+#define OVERSAMPLING 1          // O ADC amostra a SAMPLE_RATE x OVERSAMPLING (opção do CMake)
+#endif
+#define ADC_SAMPLE_RATE (SAMPLE_RATE * OVERSAMPLING)
+#if AFINADOR_STREAMING
+#define BUFFER_SIZE 64          // Tamanho do bloco analisado (um salto da janela deslizante)
+#else
+#define BUFFER_SIZE 512         // Tamanho do bloco analisado
+#endif
+#define ANALYSIS_WINDOW 1024    // Maior janela da análise contínua (256 ms a 4 kHz; o perfil pode usar menos)
+#define A4_REFERENCES 5         // Referências de afinação oferecidas no diapasão
+const uint16_t a4_references[A4_REFERENCES] = {440, 442, 443, 432, 415};  // A4 (Hz)
+#define DIAPASON_CHROMATIC_A4 9 // No perfil cromático o diapasão vai de C4 a B4, a partir de A4
+#define CENTS_TOLERANCE 5       // Tolerância para considerar a nota afinada (em cents)
+#define VOLUME_THRESHOLD 53     // RMS mínimo para detecção de som (~150 de pico a pico numa senoide)
+capture_t capture;              // Captura contínua do ADC via DMA (ping-pong)
+analysis_t analysis;            // Estado da análise (acompanhamento da frequência)
+#if AFINADOR_STREAMING
+pitch_stream_t pitch_stream;    // Janela deslizante (um salto por bloco capturado)
+#endif
+
+#if OVERSAMPLING > 1
+// Cada bloco do ADC rende CAPTURE_BLOCK_SIZE / OVERSAMPLING amostras decimadas
+_Static_assert(CAPTURE_BLOCK_SIZE % OVERSAMPLING == 0, "bloco do ADC deve ser múltiplo da razão");
+_Static_assert(BUFFER_SIZE % (CAPTURE_BLOCK_SIZE / OVERSAMPLING) == 0, "bloco de análise deve ser múltiplo da saída do decimador");
+decimator_t decimator;          // CIC + meia-banda: ADC_SAMPLE_RATE -> SAMPLE_RATE
+uint16_t decimated[BUFFER_SIZE]; // Bloco de análise sendo montado
+uint32_t decimated_count = 0;   // Amostras já decimadas no bloco atual
+uint32_t decimated_seq = 0;     // Blocos de análise entregues
+#else
+_Static_assert(CAPTURE_BLOCK_SIZE == BUFFER_SIZE, "sem decimador, o bloco do ADC é o bloco analisado");
+#endif
+_Static_assert(CAPTURE_BLOCK_SIZE <= RECORD_MAX_SAMPLES, "um bloco do ADC por quadro de gravação");
+record_queue_t record_queue;    // Blocos crus do ADC empacotados para a USB
+volatile bool recording = false; // Modo Gravar ativo (lido pelo núcleo da análise)
+uint32_t record_sent = 0;       // Quadros enviados desde a entrada no modo
+#define RECORD_FRAMES_PER_SCREEN (ADC_SAMPLE_RATE / CAPTURE_BLOCK_SIZE)  // ~1 s de quadros
+#if AFINADOR_MULTICORE
+analysis_channel_t analysis_channel;  // Último resultado publicado pelo núcleo 1
+uint32_t analysis_seen = 0;           // Sequência do último resultado lido pelo núcleo 0
+#endif
 
 // Estados do sistema
 typedef enum {
     MODE_SELECTION,  // Modo de seleção de função
     TUNER_MODE,      // Modo afinador
-    DIAPASON_MODE    // Modo diapasão
+    DIAPASON_MODE,   // Modo diapasão
+    STROBE_MODE,     // Modo estroboscópico (desvio fino em relação à nota mais próxima)
+    STRUM_MODE,      // Conferência de todas as cordas soltas num único toque
+    PROFILE_MODE,    // Escolha do instrumento e da afinação
+    RECORD_MODE      // Envio das amostras cruas do ADC pela USB
 } SystemState;
-SystemState current_state = MODE_SELECTION;  // Estado atual do sistema
-
-// Função de callback para os botões
-void button_callback(uint gpio, uint32_t events) {
-    absolute_time_t now = get_absolute_time();
-
-    // Verifica qual botão foi pressionado
-    switch (gpio) {
-        case BUTTON_A_PIN:
-            if (absolute_time_diff_us(last_press_time_A, now) / 1000 >= DEBOUNCE_TIME_MS) {
-                last_press_time_A = now;
-
-                if (current_state == MODE_SELECTION) {
-                    if (selected_note_index == false) {
-                        current_state = TUNER_MODE;  // Muda para o modo afinador
-                    } else {
-                        current_state = DIAPASON_MODE;  // Muda para o modo diapasão
-                    }
+SystemState current_state = MODE_SELECTION;  // Estado pedido pelos botões ou pelo console
+
+// Perfil como a interface o vê: o personalizado vem da cópia do núcleo 0, porque o de
+// profiles.c só é atualizado pela análise, no seu núcleo
+const tuning_profile_t *ui_profile(uint8_t id) {
+    return (id == PROFILE_CUSTOM) ? &custom_profile : profile_get(id);
+}
+
+// Notas do diapasão: as cordas do perfil confirmado ou, no cromático, a oitava de C4 a B4
+uint8_t diapason_count(void) {
+    uint8_t strings = ui_profile(selected_profile)->strings;
+    return (strings == 0) ? 12 : strings;
+}
+
+uint8_t diapason_midi(uint8_t index) {
+    const tuning_profile_t *profile = ui_profile(selected_profile);
+    return (profile->strings == 0) ? (uint8_t)(60 + index) : profile->midi[index];
+}
+
+// Interrupção do GPIO: só registra a borda; a primeira de uma sequência arma o alarme
+uint32_t button_alarm(void);
+void button_edge(hal_button_t button, bool pressed) {
+    if (buttons_edge(&buttons, (uint8_t)button, pressed, (uint32_t)hal_time_us())) {
+        // Sem alarme o debouncer ficaria ocupado para sempre; a próxima borda tenta de novo
+        if (!hal_alarm_start(BUTTON_DEBOUNCE_MS * 1000, button_alarm)) buttons_alarm_failed(&buttons);
+    }
+}
+
+// Interrupção do alarme: debounce, toque longo e repetição
+uint32_t button_alarm(void) {
+    return buttons_update(&buttons, (uint32_t)hal_time_us());
+}
+
+// Eventos dos botões, tratados no laço principal (fora de qualquer interrupção)
+void handle_button(const button_event_t *event) {
+    // Segurar o joystick continua avançando; os outros botões só contam o aperto
+    bool step = event->action == BUTTON_PRESS ||
+                (event->action == BUTTON_REPEAT && event->button == HAL_BUTTON_JOYSTICK);
+    if (!step) return;
+
+    switch (event->button) {
+        case HAL_BUTTON_A:
+            if (current_state == MODE_SELECTION) {
+                if (selected_note_index == 0) {
+                    current_state = TUNER_MODE;  // Muda para o modo afinador
+                } else if (selected_note_index == 1) {
+                    diapason_index = (ui_profile(selected_profile)->strings == 0) ? DIAPASON_CHROMATIC_A4 : 0;
+                    current_state = DIAPASON_MODE;  // Muda para o modo diapasão
+                } else if (selected_note_index == 2) {
+                    current_state = STROBE_MODE;  // Muda para o modo estroboscópico
+                } else if (selected_note_index == 3) {
+                    current_state = STRUM_MODE;  // Muda para a conferência das cordas
+                } else if (selected_note_index == 4) {
+                    browsed_profile = selected_profile;
+                    current_state = PROFILE_MODE;  // Muda para a escolha do perfil
+                } else {
+                    current_state = RECORD_MODE;  // Muda para a gravação pela USB
                 }
+            } else if (current_state == PROFILE_MODE) {
+                selected_profile = browsed_profile;  // Confirma o perfil mostrado
+                current_state = MODE_SELECTION;
+            } else if (current_state == DIAPASON_MODE) {
+                reference_index = (reference_index + 1) % A4_REFERENCES;  // Alterna a referência A4
             }
             break;
 
-        case BUTTON_B_PIN:
-            if (absolute_time_diff_us(last_press_time_B, now) / 1000 >= DEBOUNCE_TIME_MS) {
-                last_press_time_B = now;
-                current_state = MODE_SELECTION;  // Volta para o modo de seleção
-            }
+        case HAL_BUTTON_B:
+            current_state = MODE_SELECTION;  // Volta para o modo de seleção
             break;
 
-        case JOYSTICK_BUTTON_PIN:
-            if (absolute_time_diff_us(last_press_time_JOY, now) / 1000 >= DEBOUNCE_TIME_MS) {
-                last_press_time_JOY = now;
-
-                if (current_state == MODE_SELECTION) {
-                    selected_note_index = (selected_note_index == false) ? 1 : 0;  // Alterna entre opções
-                }
+        case HAL_BUTTON_JOYSTICK:
+            if (current_state == MODE_SELECTION) {
+                selected_note_index = (selected_note_index + 1) % MENU_OPTIONS;  // Alterna entre opções
+            } else if (current_state == PROFILE_MODE) {
+                browsed_profile = (browsed_profile + 1) % PROFILE_COUNT;  // Alterna entre perfis
+            } else if (current_state == DIAPASON_MODE) {
+                diapason_index = (diapason_index + 1) % diapason_count();  // Alterna a nota tocada
             }
             break;
     }
 }
 
-// Toca a nota A (440Hz)
-void play_diapason() {
-    uint slice_num = pwm_gpio_to_slice_num(BUZZER_PIN);
-    uint channel = pwm_gpio_to_channel(BUZZER_PIN);
 
-    uint32_t sys_clock = 125000000;  // Clock do sistema: 125MHz
-    float clkdiv = 100.0;            // Divisor de clock para gerar 440Hz
-    uint16_t wrap_value = (sys_clock / clkdiv) / 430;  // Calcula o valor de wrap para 440Hz
+// Função para desligar todos os LEDs RGB
+void clear_leds() {
+    hal_rgb_set(false, false, false);
+}
 
-    pwm_set_clkdiv(slice_num, clkdiv);
-    pwm_set_wrap(slice_num, wrap_value);
+// Função para controlar os LEDs RGB conforme o desvio em cents da nota mais próxima
+void update_leds(const note_info_t *note) {
+    const fixed_t tolerance = FIXED_FROM_INT(CENTS_TOLERANCE);
+    if (note->cents >= -tolerance && note->cents <= tolerance) {
+        // Afinado: Verde
+        hal_rgb_set(false, true, false);
+    } else if (note->cents < -tolerance) {
+        // Grave: Amarelo (Vermelho + Verde)
+        hal_rgb_set(true, true, false);
+    } else {
+        // Agudo: Vermelho
+        hal_rgb_set(true, false, false);
+    }
+}
 
-    // Define o duty cycle para 0,8% (volume baixo)
-    pwm_set_chan_level(slice_num, channel, wrap_value / 125);  
+// Função para inicializar os componentes
+void init_components() {
+    // Configura os botões como entradas com pull-up e interrupção nas duas bordas
+    static const unsigned int button_pins[HAL_BUTTONS] = {BUTTON_A_PIN, BUTTON_B_PIN, JOYSTICK_BUTTON_PIN};
+    buttons_init(&buttons, HAL_BUTTONS);
+    hal_buttons_init(button_pins, button_edge);
 
-    pwm_set_enabled(slice_num, true);  // Habilita o PWM
-}
+    // Configura os LEDs RGB como saídas
+    hal_rgb_init(LED_RED_PIN, LED_GREEN_PIN, LED_BLUE_PIN);
+
+    // Configura o I2C para o display OLED
+    hal_oled_bus_init(I2C_PORT, I2C_SDA, I2C_SCL, 400 * 1000);
 
-// Para o som do buzzer
-void stop_diapason() {
-    uint slice_num = pwm_gpio_to_slice_num(BUZZER_PIN);
-    pwm_set_enabled(slice_num, false);  // Desabilita o PWM
+    // Inicializa o PIO e a máquina de estado para os LEDs WS2812
+    sm = ws2812Init(pio0);
+
+    note_map_set_reference(FIXED_FROM_INT(a4_references[0]));  // Tabela de notas cromáticas (B0 a C7)
+    custom_profile = *profile_get(PROFILE_CUSTOM);  // Antes do núcleo 1 começar a ler
+    record_queue_init(&record_queue);
+    analysis_init(&analysis, SAMPLE_RATE, VOLUME_THRESHOLD);
+    // O detector (janela, faixa e plano da FFT) é preparado pelo perfil, no primeiro bloco
+#if OVERSAMPLING > 1
+    decimator_init(&decimator, ADC_SAMPLE_RATE, SAMPLE_RATE);  // Filtro anti-aliasing
+#endif
+#if AFINADOR_MULTICORE
+    analysis_channel_init(&analysis_channel);  // A captura é iniciada pelo núcleo 1
+#else
+    hal_mic_start(&capture, MIC_PIN, ADC_SAMPLE_RATE);  // ADC2 (GPIO28) em free-running via DMA
+#endif
+    // O PWM do buzzer é configurado por tone_start(), com o clock real do sistema
 }
 
-// Função para calcular a frequência de uma nota em relação a A4
-float calculate_note_frequency(int8_t n) {
-    return pow(2.0, n / 12.0) * 440.0;  // Fórmula para calcular a frequência da nota
+// Obtém o próximo bloco de BUFFER_SIZE amostras a SAMPLE_RATE. Com sobreamostragem,
+// decima os blocos prontos do ADC até completar um bloco de análise; o bloco devolvido
+// vale até a próxima chamada.
+bool acquire_block(const uint16_t **block, uint32_t *seq) {
+#if OVERSAMPLING > 1
+    const uint16_t *raw;
+    uint32_t raw_seq;
+    while (decimated_count < BUFFER_SIZE && capture_acquire(&capture, &raw, &raw_seq)) {
+        if (recording) {
+            record_queue_push(&record_queue, raw, CAPTURE_BLOCK_SIZE, raw_seq, ADC_SAMPLE_RATE);
+            hal_notify();  // Acorda o núcleo 0 para enviar o quadro
+        }
+        TELEMETRY_BEGIN(CAPTURE);
+        decimated_count += decimator_process(&decimator, raw, CAPTURE_BLOCK_SIZE, &decimated[decimated_count]);
+        capture_release(&capture);  // O bloco bruto já foi consumido pelo filtro
+        TELEMETRY_END(CAPTURE);
+    }
+    if (decimated_count < BUFFER_SIZE) return false;
+
+    decimated_count = 0;
+    *block = decimated;
+    *seq = decimated_seq++;
+    return true;
+#else
+    TELEMETRY_BEGIN(CAPTURE);
+    bool ready = capture_acquire(&capture, block, seq);
+    if (ready) TELEMETRY_END(CAPTURE);
+    if (ready && recording) {
+        record_queue_push(&record_queue, *block, CAPTURE_BLOCK_SIZE, *seq, ADC_SAMPLE_RATE);
+        hal_notify();  // Acorda o núcleo 0 para enviar o quadro
+    }
+    return ready;
+#endif
 }
 
-// Função para calcular a frequência do sinal capturado
-float calculate_frequency(uint16_t *buffer, uint32_t buffer_size, uint32_t sample_rate) {
-    uint32_t zero_crossings = 0;
+// Libera o bloco obtido por acquire_block()
+void release_block(void) {
+#if OVERSAMPLING == 1
+    capture_release(&capture);  // Devolve a metade do ping-pong à DMA
+#endif
+}
 
-    // Conta os cruzamentos por zero no sinal
-    for (uint32_t i = 1; i < buffer_size; i++) {
-        if ((buffer[i - 1] < 2048 && buffer[i] >= 2048)) {  // Detecta cruzamento por zero (subindo)
-            zero_crossings++;
+// Aplica o perfil confirmado na tela de perfis (faixa do detector, janela e cordas) e
+// a referência A4 escolhida no diapasão. Roda no núcleo da análise, entre dois blocos,
+// então nunca troca a faixa nem a tabela de notas no meio de uma estimativa.
+void apply_profile(void) {
+    // Perfil personalizado vindo do console: copiado como no canal de resultados; uma
+    // cópia interrompida pelo núcleo 0 é descartada e refeita no próximo bloco
+    uint32_t seq = custom_seq;
+    if (seq != applied_custom && !(seq & 1)) {
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        tuning_profile_t edited = custom_profile;
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (custom_seq == seq) {
+            profile_set_custom(edited.midi, edited.strings, edited.min_freq, edited.max_freq);
+            applied_custom = seq;
         }
     }
 
-    if (zero_crossings < 2) return 0.0;  // Se houver poucos cruzamentos, não há som detectado
+    uint8_t id = selected_profile;
+    uint8_t reference = reference_index;
+    note_map_set_reference(FIXED_FROM_INT(a4_references[reference]));
+    applied_reference = reference;
+    const tuning_profile_t *profile = profile_get(id);
+#if AFINADOR_STREAMING
+    pitch_stream_init(&pitch_stream, profile_window(profile, SAMPLE_RATE, ANALYSIS_WINDOW), BUFFER_SIZE,
+                      SAMPLE_RATE, profile->min_freq, profile->max_freq);
+#endif
+    analysis_set_profile(&analysis, profile, BUFFER_SIZE);
+    applied_profile = id;
+}
 
-    float frequency = (zero_crossings * sample_rate) / (buffer_size);  // Calcula a frequência
-    return frequency * CALIBRATION_FACTOR;  // Aplica o fator de calibração
+// Analisa um bloco capturado; retorna false se ele não produziu uma estimativa
+bool analyze_block(const uint16_t *buffer, uint32_t seq, analysis_result_t *result) {
+    if (selected_profile != applied_profile || reference_index != applied_reference ||
+        custom_seq != applied_custom) {
+        apply_profile();
+    }
+    uint8_t stages = analysis_stages;
+    if (stages != analysis.stages) analysis_set_stages(&analysis, stages);  // Estrobo e cordas só nos seus modos
+#if AFINADOR_STREAMING
+    return analysis_process_stream(&analysis, &pitch_stream, buffer, BUFFER_SIZE, seq, result);
+#else
+    analysis_process(&analysis, buffer, BUFFER_SIZE, seq, result);
+    return true;
+#endif
 }
 
-// Função para suavizar a frequência detectada
-float smooth_frequency(float new_freq, float old_freq, float smoothing_factor) {
-    if (new_freq == 0.0) return old_freq;  // Mantém a última frequência válida se não houver sinal
-    return (smoothing_factor * new_freq) + ((1.0 - smoothing_factor) * old_freq);  // Suaviza a frequência
+#if AFINADOR_MULTICORE
+// Núcleo 1: captura e análise contínuas. A interrupção da DMA da captura é habilitada
+// neste núcleo, então um envio lento ao OLED no núcleo 0 não atrasa a análise.
+void core1_entry() {
+    telemetry_init_core();  // O SysTick é próprio de cada núcleo
+    hal_mic_start(&capture, MIC_PIN, ADC_SAMPLE_RATE);  // ADC2 (GPIO28) em free-running via DMA
+
+    while (true) {
+        const uint16_t *buffer;
+        uint32_t seq;
+        if (!acquire_block(&buffer, &seq)) {
+            hal_wait_for_event();  // Dorme até a próxima interrupção (a entrada na exceção acorda o WFE)
+            continue;
+        }
+
+        analysis_result_t result;
+        bool ready = analyze_block(buffer, seq, &result);
+        release_block();
+        if (ready) {
+            analysis_publish(&analysis_channel, &result);  // Substitui o resultado anterior
+            hal_notify();  // Acorda o núcleo 0, que dorme em wait_for_event()
+        }
+    }
+}
+#endif
+
+// Obtém o próximo resultado da análise; retorna false se ainda não há bloco novo
+bool next_analysis(analysis_result_t *result) {
+#if AFINADOR_MULTICORE
+    // Apenas o resultado mais recente do núcleo 1; os intermediários são descartados
+    return analysis_latest(&analysis_channel, &analysis_seen, result);
+#else
+    // Obtém o próximo bloco completo; a DMA segue preenchendo a outra metade
+    const uint16_t *buffer;
+    uint32_t seq;
+    if (!acquire_block(&buffer, &seq)) {
+        return false;
+    }
+    bool ready = analyze_block(buffer, seq, result);
+    release_block();  // Bloco não é mais necessário
+    return ready;
+#endif
 }
 
-// Função para calcular a amplitude do sinal
-uint16_t calculate_amplitude(uint16_t *buffer, uint32_t buffer_size) {
-    uint16_t min = 4095, max = 0;
+// ---------------------------------------------------------------------------
+// Máquina de estados: transições separadas da renderização.
+// As ações de entrada e saída rodam uma vez por transição; cada dispositivo só é
+// redesenhado quando suas entradas mudam, e entre eventos o núcleo dorme.
+
+SystemState active_state = MODE_SELECTION;  // Estado cujas ações de entrada já rodaram
+uint8_t shown_selection = 0xFF;             // Opção do menu exibida no OLED
+
+// Tela do menu de seleção (depende apenas da opção selecionada)
+void render_menu(ssd1306_t *ssd) {
+    shown_selection = selected_note_index;
+    ssd1306_fill(ssd, false);  // Limpa o display
+    ssd1306_draw_label(ssd, "1: Afinador", 4, 1);
+    ssd1306_draw_label(ssd, "2: Diapasao", 4, 11);
+    ssd1306_draw_label(ssd, "3: Estrobo", 4, 21);
+    ssd1306_draw_label(ssd, "4: Cordas", 4, 31);
+    ssd1306_draw_label(ssd, "5: Perfil", 4, 41);
+    ssd1306_draw_label(ssd, "6: Gravar", 4, 51);
+    ssd1306_rect(ssd, 10 * shown_selection, 0, 128, 10, true, false);  // Destaca a opção
+    ssd1306_send_data(ssd); // Envia os dados para o display
+}
 
-    // Encontra os valores mínimo e máximo no buffer
-    for (uint32_t i = 0; i < buffer_size; i++) {
-        if (buffer[i] < min) min = buffer[i];
-        if (buffer[i] > max) max = buffer[i];
+// Saídas do modo afinador para um resultado da análise
+void render_tuner(ssd1306_t *ssd, LedMatrix ledMatrix, const analysis_result_t *result) {
+    TELEMETRY_BEGIN(RENDER);
+    ssd1306_fill(ssd, false);  // Limpa o display
+    ssd1306_draw_label(ssd, "Modo Afinador", 16, 4);
+    clearLedMatrix(ledMatrix);
+
+    // Verifica se o volume está acima do limiar e se já há uma nota travada
+    if (result->active && result->frequency > 0) {
+        const note_info_t *note = &result->note;
+
+        // Texto formatado em ponto fixo (sem printf de float)
+        char freq_str[20];
+#if !AFINADOR_TELEMETRY
+        // Com a telemetria, a serial leva apenas os quadros CSV
+        fixed_append_str(fixed_append(freq_str, result->frequency, 2), " Hz");
+        printf("Frequência detectada: %s\n", freq_str);
+#endif
+
+        // Frequência em dígitos de 16 pixels, centrada com a unidade, ex.: "110.0 Hz"
+        uint8_t digits = (uint8_t)(fixed_append(freq_str, result->frequency, 1) - freq_str);
+        uint8_t left = (WIDTH - 16 * digits - 24) / 2;
+        ssd1306_draw_string_scaled(ssd, freq_str, left, 16, 2);
+        ssd1306_draw_label(ssd, "Hz", left + 16 * digits + 8, 24);
+
+        if (result->in_range) {
+            // Exibe a nota na matriz de LEDs (sustenidos em azul)
+            getChromaticNote(note->pitch_class, ledMatrix);
+
+            // Atualiza os LEDs RGB conforme o estado de afinação
+            update_leds(note);
+
+            // Exibe a nota e o desvio em cents, ex.: "A#2 -12c"
+            char note_str[20];
+            note_map_format(note, note_str);
+            char *end = fixed_append_str(note_str + strlen(note_str), " ");
+            fixed_append_str(fixed_append_int(end, fixed_round(note->cents), true), "c");
+            ssd1306_draw_string(ssd, note_str, 32, 40);
+        } else {
+            // Fora da faixa B0..C7: apenas a frequência é exibida
+            clear_leds();
+        }
+    } else {
+        // Volume abaixo do limiar (ou nota ainda não travada): ignora o sinal
+        clear_leds(); // Desliga os LEDs RGB
+        ssd1306_draw_label(ssd, "Toque a nota", 17, 20);
     }
-    return max - min;  // Retorna a amplitude (diferença entre máximo e mínimo)
+    TELEMETRY_END(RENDER);
+
+    TELEMETRY_BEGIN(LEDS);
+    displayPattern(ledMatrix);  // Reenviado só se o padrão mudou
+    TELEMETRY_END(LEDS);
+    TELEMETRY_BEGIN(FLUSH);
+    ssd1306_send_data(ssd);     // Envia apenas as janelas alteradas
+    TELEMETRY_END(FLUSH);
 }
 
-// Função para determinar a nota mais próxima da frequência detectada
-uint8_t get_closest_note(float frequency) {
-    uint8_t closest_note = 0;
-    float min_diff = 1000.0;
-    float new_frequency = frequency;
-
-    // Normaliza a frequência para a oitava correta
-    if (frequency > 500) { new_frequency /= 2; }
-    if (frequency < 250 && frequency > 125) { new_frequency *= 2; }
-    if (frequency < 125) { new_frequency *= 4; }
-
-    // Encontra a nota mais próxima
-    for (uint8_t i = 0; i < 7; i++) {
-        float base_freq = calculate_note_frequency(semitones_from_A4[i]);
-        float diff = fabs(new_frequency - base_freq);
-
-        if (diff < min_diff) {
-            min_diff = diff;
-            closest_note = i;
+// Faixas do estrobo no OLED: listras com períodos de 32, 16 e 8 pixels deslocadas pelo
+// ângulo do fasor. A faixa b gira 2^b vezes mais rápido, como os anéis de harmônicos
+// de um estrobo mecânico; afinado, o desenho fica parado.
+void draw_strobe_bands(ssd1306_t *ssd, uint32_t angle) {
+    for (uint8_t b = 0; b < 3; b++) {
+        int period = 32 >> b;
+        uint32_t turns = angle << b;
+        int offset = (int)(((turns >> 16) * (uint32_t)period) >> 16);
+        uint8_t top = 34 + 10 * b;
+        for (int x = offset - period; x < 128; x += period) {
+            int left = (x < 0) ? 0 : x;
+            int right = (x + period / 2 > 128) ? 128 : x + period / 2;
+            if (right > left) ssd1306_rect(ssd, top, left, right - left, 9, true, true);
         }
     }
+}
+
+// Estrobo na matriz: um LED percorre a borda (sentido horário quando agudo), na cor
+// do estado de afinação
+void draw_strobe_ring(LedMatrix ledMatrix, uint32_t angle, fixed_t cents) {
+    const fixed_t tolerance = FIXED_FROM_INT(CENTS_TOLERANCE);
+    LedConfig color = {76, 0, 0};      // Agudo: vermelho
+    if (cents < -tolerance) {
+        color.green = 76;              // Grave: amarelo
+    } else if (cents <= tolerance) {
+        color.red = 0;                 // Afinado: verde
+        color.green = 76;
+    }
 
-    return closest_note;
+    int perimeter = 2 * (WS2812_ROWS + WS2812_COLS) - 4;
+    int p = (int)(((angle >> 16) * (uint32_t)perimeter) >> 16);
+    // Posição p na borda, no sentido horário a partir do canto superior esquerdo
+    if (p < WS2812_COLS) {
+        ledMatrix[0][p] = color;
+        return;
+    }
+    p -= WS2812_COLS;
+    if (p < WS2812_ROWS - 1) {
+        ledMatrix[p + 1][WS2812_COLS - 1] = color;
+        return;
+    }
+    p -= WS2812_ROWS - 1;
+    if (p < WS2812_COLS - 1) {
+        ledMatrix[WS2812_ROWS - 1][WS2812_COLS - 2 - p] = color;
+        return;
+    }
+    p -= WS2812_COLS - 1;
+    ledMatrix[WS2812_ROWS - 2 - p][0] = color;
 }
 
-// Função para desligar todos os LEDs RGB
-void clear_leds() {
-    gpio_put(LED_RED_PIN, false);
-    gpio_put(LED_GREEN_PIN, false);
-    gpio_put(LED_BLUE_PIN, false);
+// Saídas do modo estroboscópico para um resultado da análise
+void render_strobe(ssd1306_t *ssd, LedMatrix ledMatrix, const analysis_result_t *result) {
+    ssd1306_fill(ssd, false);  // Limpa o display
+    ssd1306_draw_label(ssd, "Modo Estrobo", 16, 4);
+    clearLedMatrix(ledMatrix);
+
+    if (result->strobe.valid) {
+        // Desvio fino do estrobo nos LEDs RGB, com a mesma tolerância do afinador
+        note_info_t note = result->note;
+        note.cents = result->strobe.cents;
+        update_leds(&note);
+
+        // Nota e, em dígitos de 16 pixels, o desvio com um décimo de cent, ex.: "A2 +0.4c"
+        char note_str[20];
+        note_map_format(&note, note_str);
+        ssd1306_draw_string(ssd, note_str, 0, 24);
+        char *end = note_str;
+        if (note.cents >= 0) end = fixed_append_str(end, "+");
+        fixed_append_str(fixed_append(end, note.cents, 1), "c");
+        ssd1306_draw_string_scaled(ssd, note_str, 32, 16, 2);
+
+        draw_strobe_bands(ssd, result->strobe.angle);
+        draw_strobe_ring(ledMatrix, result->strobe.angle, note.cents);
+    } else {
+        // Sem sinal na nota alvo (ou o acompanhamento da fase ainda acomodando)
+        clear_leds();
+        ssd1306_draw_label(ssd, "Toque a nota", 17, 20);
+    }
+
+    displayPattern(ledMatrix);  // Reenviado só se o padrão mudou
+    ssd1306_send_data(ssd);     // Envia apenas as janelas alteradas
 }
 
-// Função para controlar os LEDs RGB conforme o estado de afinação
-void update_leds(float detected_freq, uint8_t note_index) {
-    float target_freq = calculate_note_frequency(semitones_from_A4[note_index]);
-    float new_target_freq = target_freq;
+// Barra do desvio de uma corda: centro em x = 106, 21 pixels para 50 cents
+void draw_strum_bar(ssd1306_t *ssd, uint8_t top, fixed_t cents) {
+    const fixed_t limit = FIXED_FROM_INT(50);
+    if (cents > limit) cents = limit;
+    if (cents < -limit) cents = -limit;
+    int width = fixed_round(cents * 21) / 50;
+    ssd1306_vline(ssd, 106, top, top + 6, true);
+    if (width > 0) ssd1306_rect(ssd, top + 2, 107, width, 3, true, true);
+    if (width < 0) ssd1306_rect(ssd, top + 2, 106 + width, -width, 3, true, true);
+}
 
-    // Ajusta a frequência alvo para a oitava correta
-    if (detected_freq < 125) { new_target_freq /= 4; }
-    if (detected_freq < 250 && detected_freq > 125) { new_target_freq /= 2; }
-    if (detected_freq > 500) { new_target_freq *= 2; }
+// Saídas da conferência das cordas: uma linha por corda com nota, desvio e barra.
+// Os LEDs RGB mostram a corda válida mais desafinada.
+void render_strum(ssd1306_t *ssd, const analysis_result_t *result) {
+    ssd1306_fill(ssd, false);  // Limpa o display
+    ssd1306_draw_label(ssd, "Modo Cordas", 20, 4);
+
+    bool any = false;
+    note_info_t worst = {0};
+    for (uint8_t i = 0; i < result->strum.count; i++) {
+        const strum_string_t *string = &result->strum.strings[i];
+        uint8_t top = 16 + 8 * i;
+
+        // Corda e desvio com um décimo de cent, ex.: "E2 +1.2c" (ou "E2 --" sem sinal)
+        note_info_t note;
+        note_map_note(string->midi, &note);
+        note.cents = string->cents;
+        char line[20];
+        note_map_format(&note, line);
+        char *end = fixed_append_str(line + strlen(line), " ");
+        if (string->valid) {
+            if (note.cents >= 0) end = fixed_append_str(end, "+");
+            fixed_append_str(fixed_append(end, note.cents, 1), "c");
+            draw_strum_bar(ssd, top, note.cents);
+            if (!any || fixed_abs(note.cents) > fixed_abs(worst.cents)) worst = note;
+            any = true;
+        } else {
+            fixed_append_str(end, "--");
+        }
+        ssd1306_draw_string(ssd, line, 0, top);
+    }
 
-    // Controla os LEDs conforme a diferença entre a frequência detectada e a alvo
-    if (detected_freq < new_target_freq + FREQ_TOLERANCE && detected_freq > new_target_freq - FREQ_TOLERANCE) {
-        // Afinado: Verde
-        gpio_put(LED_RED_PIN, false);
-        gpio_put(LED_GREEN_PIN, true);
-        gpio_put(LED_BLUE_PIN, false);
-    } else if (detected_freq < new_target_freq - FREQ_TOLERANCE) {
-        // Grave: Amarelo (Vermelho + Verde)
-        gpio_put(LED_RED_PIN, true);
-        gpio_put(LED_GREEN_PIN, true);
-        gpio_put(LED_BLUE_PIN, false);
-    } else if (detected_freq > new_target_freq + FREQ_TOLERANCE) {
-        // Agudo: Vermelho
-        gpio_put(LED_RED_PIN, true);
-        gpio_put(LED_GREEN_PIN, false);
-        gpio_put(LED_BLUE_PIN, false);
+    if (any) {
+        update_leds(&worst);
     } else {
-        // Desliga os LEDs se não estiver em nenhum dos estados acima
         clear_leds();
     }
+    ssd1306_send_data(ssd);     // Envia apenas as janelas alteradas
 }
 
-// Função para inicializar os componentes
-void init_components() {
-    // Configura os botões como entradas com pull-up
-    gpio_init(BUTTON_A_PIN);
-    gpio_init(BUTTON_B_PIN);
-    gpio_init(JOYSTICK_BUTTON_PIN);
-    gpio_set_dir(BUTTON_A_PIN, GPIO_IN);
-    gpio_set_dir(BUTTON_B_PIN, GPIO_IN);
-    gpio_set_dir(JOYSTICK_BUTTON_PIN, GPIO_IN);
-    gpio_pull_up(BUTTON_A_PIN);
-    gpio_pull_up(BUTTON_B_PIN);
-    gpio_pull_up(JOYSTICK_BUTTON_PIN);
-
-    // Configura interrupções para os botões
-    gpio_set_irq_enabled_with_callback(BUTTON_A_PIN, GPIO_IRQ_EDGE_FALL, true, &button_callback);
-    gpio_set_irq_enabled_with_callback(BUTTON_B_PIN, GPIO_IRQ_EDGE_FALL, true, &button_callback);
-    gpio_set_irq_enabled_with_callback(JOYSTICK_BUTTON_PIN, GPIO_IRQ_EDGE_FALL, true, &button_callback);
+// Tela de perfis: nome, cordas soltas e faixa procurada do perfil mostrado
+uint8_t shown_profile = 0xFF;  // Perfil exibido no OLED
+
+void render_profile(ssd1306_t *ssd) {
+    shown_profile = browsed_profile;
+    const tuning_profile_t *profile = ui_profile(shown_profile);
+    ssd1306_fill(ssd, false);  // Limpa o display
+    ssd1306_draw_label(ssd, "Perfil", 40, 4);
+    ssd1306_draw_label(ssd, profile->name, 0, 20);
+
+    // Cordas sem a oitava, ex.: "E A D G B E"
+    char line[20];
+    char *end = line;
+    *end = '\0';
+    if (profile->strings == 0) end = fixed_append_str(end, "Todas as notas");
+    for (uint8_t i = 0; i < profile->strings; i++) {
+        if (i > 0) end = fixed_append_str(end, " ");
+        end = fixed_append_str(end, note_map_names[profile->midi[i] % 12]);
+    }
+    ssd1306_draw_string(ssd, line, 0, 36);
+
+    // Faixa do detector, ex.: "65-440 Hz"
+    end = fixed_append_int(line, profile->min_freq, false);
+    end = fixed_append_str(end, "-");
+    fixed_append_str(fixed_append_int(end, profile->max_freq, false), " Hz");
+    ssd1306_draw_string(ssd, line, 0, 52);
+    ssd1306_send_data(ssd); // Envia os dados para o display
+}
 
-    // Configura os LEDs RGB como saídas
-    gpio_init(LED_RED_PIN);
-    gpio_init(LED_GREEN_PIN);
-    gpio_init(LED_BLUE_PIN);
-    gpio_set_dir(LED_RED_PIN, GPIO_OUT);
-    gpio_set_dir(LED_GREEN_PIN, GPIO_OUT);
-    gpio_set_dir(LED_BLUE_PIN, GPIO_OUT);
+// Diapasão: nota e referência tocadas. O tom sai do DDS (tabela de seno tocada pela
+// DMA no PWM do buzzer), então a CPU só participa quando a nota muda.
+uint8_t shown_diapason = 0xFF;   // Nota tocada e exibida
+uint8_t shown_reference = 0xFF;  // Referência A4 tocada e exibida
+
+void render_diapason(ssd1306_t *ssd, LedMatrix ledMatrix) {
+    shown_diapason = diapason_index;
+    shown_reference = reference_index;
+    note_info_t note;
+    note_map_note(diapason_midi(shown_diapason), &note);
+
+    // A análise só troca a tabela de notas no seu núcleo; aqui a frequência é calculada
+    // direto da referência escolhida
+    tone_plan_t plan;
+    fixed_t frequency = note_map_frequency_at(FIXED_FROM_INT(a4_references[shown_reference]), note.midi);
+    bool playing = tone_start(BUZZER_PIN, frequency, TONE_DEFAULT_AMPLITUDE, &plan);
+
+    ssd1306_fill(ssd, false);  // Limpa o display
+    ssd1306_draw_label(ssd, "Modo Diapasao", 18, 4);
+
+    // Nota e frequência efetivamente tocada, ex.: "A4 440.000 Hz"
+    char line[24];
+    note_map_format(&note, line);
+    char *end = fixed_append_str(line + strlen(line), " ");
+    if (playing) {
+        fixed_append_str(fixed_append(end, plan.frequency, 3), " Hz");
+    } else {
+        fixed_append_str(end, "--");
+    }
+    ssd1306_draw_string(ssd, line, 4, 24);
 
-    // Configura o I2C para o display OLED
-    i2c_init(I2C_PORT, 400 * 1000);
-    gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
-    gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
-    gpio_pull_up(I2C_SDA);
-    gpio_pull_up(I2C_SCL);
+    // Referência, ex.: "A4 = 442 Hz"
+    end = fixed_append_str(line, "A4 = ");
+    fixed_append_str(fixed_append_int(end, a4_references[shown_reference], false), " Hz");
+    ssd1306_draw_string(ssd, line, 4, 44);
+    ssd1306_send_data(ssd);
 
-    // Inicializa o PIO e a máquina de estado para os LEDs WS2812
-    sm = ws2812Init(pio0);
+    clearLedMatrix(ledMatrix);
+    getChromaticNote(note.pitch_class, ledMatrix);  // Nota tocada (sustenidos em azul)
+    displayPattern(ledMatrix);
+}
+
+// Tela do modo Gravar: taxa do ADC, quadros enviados e descartados
+uint32_t shown_record = 0xFFFFFFFF;  // Quadros enviados na última tela
+
+void render_record(ssd1306_t *ssd) {
+    shown_record = record_sent;
+    ssd1306_fill(ssd, false);  // Limpa o display
+    ssd1306_draw_label(ssd, "Modo Gravar", 20, 4);
+
+    char line[20];
+    fixed_append_str(fixed_append_int(fixed_append_str(line, "USB "), ADC_SAMPLE_RATE, false), " Hz");
+    ssd1306_draw_string(ssd, line, 4, 20);
+    fixed_append_int(fixed_append_str(line, "Quadros "), (int32_t)shown_record, false);
+    ssd1306_draw_string(ssd, line, 4, 36);
+    fixed_append_int(fixed_append_str(line, "Perdidos "), (int32_t)record_queue.dropped, false);
+    ssd1306_draw_string(ssd, line, 4, 52);
+    ssd1306_send_data(ssd);
+}
 
-    // Inicializa o ADC para o microfone
-    adc_init();
-    adc_gpio_init(MIC_PIN);
-    adc_select_input(2);  // Usa o canal ADC2 (GPIO28)
+// Envia pela serial os quadros prontos; a escrita bloqueia enquanto a USB estiver cheia,
+// e a fila absorve o atraso (o excesso é descartado e aparece como lacuna na sequência)
+void send_record_frames(void) {
+    const uint8_t *frame;
+    size_t size;
+    while (record_queue_peek(&record_queue, &frame, &size)) {
+        hal_console_write(frame, size);
+        record_queue_release(&record_queue);
+        record_sent++;
+    }
+    fflush(stdout);
+}
+
+// Define e seleciona o perfil personalizado a partir das cordas em texto. O núcleo 0
+// escreve custom_profile com a sequência ímpar; a análise o copia em apply_profile().
+void set_custom_profile(const char *text) {
+    tuning_profile_t edited;
+    if (!profile_parse_custom(text, &edited)) {
+        if (current_state != RECORD_MODE) printf("Perfil invalido: %s\n", text);
+        return;
+    }
+    uint32_t seq = custom_seq;
+    custom_seq = seq + 1;  // Ímpar: escrita em andamento
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    custom_profile = edited;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    custom_seq = seq + 2;
+
+    selected_profile = PROFILE_CUSTOM;
+    browsed_profile = PROFILE_CUSTOM;
+    shown_profile = 0xFF;  // Redesenha a tela de perfis, se aberta
+    diapason_index = (edited.strings == 0) ? DIAPASON_CHROMATIC_A4 : 0;  // Cordas novas
+    shown_diapason = 0xFF;
+    if (current_state != RECORD_MODE) {
+        printf("Perfil personalizado: %u cordas, %u-%u Hz\n", edited.strings, edited.min_freq, edited.max_freq);
+    }
+}
+
+// Console serial: 'r' entra no modo Gravar de qualquer tela, 's' volta ao menu e 'c'
+// seguido das cordas e de Enter define o perfil personalizado, ex.: "c D2 A2 D3 G3 B3 E4"
+char console_line[32];       // Cordas do comando 'c' em andamento
+uint8_t console_length = 0;
+bool console_editing = false;  // Lendo a linha do comando 'c'
+bool console_overflow = false; // Linha maior que console_line (descartada)
+
+void poll_console(void) {
+    int c;
+    while ((c = hal_console_getc()) >= 0) {
+        if (!console_editing) break;
+        if (c == '\r' || c == '\n') {
+            console_line[console_length] = '\0';
+            console_editing = false;
+            if (console_overflow) {
+                if (current_state != RECORD_MODE) printf("Perfil invalido: linha longa demais\n");
+            } else {
+                set_custom_profile(console_line);
+            }
+            return;
+        }
+        if (console_length < sizeof(console_line) - 1) {
+            console_line[console_length++] = (char)c;
+        } else {
+            console_overflow = true;
+        }
+    }
 
-    // Inicializa o PWM para o buzzer
-    gpio_set_function(BUZZER_PIN, GPIO_FUNC_PWM);  // Configura o pino do buzzer como PWM
-    uint slice_num = pwm_gpio_to_slice_num(BUZZER_PIN);
-    pwm_set_clkdiv(slice_num, 8.0);  // Define o divisor de clock para o PWM
+    if (c == 'r' || c == 'R') {
+        current_state = RECORD_MODE;
+    } else if ((c == 's' || c == 'S') && current_state == RECORD_MODE) {
+        current_state = MODE_SELECTION;
+    } else if (c == 'c' || c == 'C') {
+        console_editing = true;
+        console_length = 0;
+        console_overflow = false;
+    }
+}
+
+// Ações de entrada: configuram as saídas que não mudam enquanto o estado durar
+void enter_state(SystemState state, ssd1306_t *ssd, LedMatrix ledMatrix) {
+    switch (state) {
+        case MODE_SELECTION:
+            clear_leds(); // Desliga os LEDs RGB
+            clearLedMatrix(ledMatrix); // Limpa a matriz de LEDs
+            displayPattern(ledMatrix);
+            render_menu(ssd);
+            break;
+
+        case TUNER_MODE:
+            // A tela é redesenhada a cada resultado; até lá, mostra o convite
+            ssd1306_fill(ssd, false);
+            ssd1306_draw_label(ssd, "Modo Afinador", 16, 4);
+            ssd1306_draw_label(ssd, "Toque a nota", 17, 20);
+            ssd1306_send_data(ssd);
+            break;
+
+        case DIAPASON_MODE:
+            render_diapason(ssd, ledMatrix);  // Começa a tocar a nota escolhida
+            break;
+
+        case STROBE_MODE:
+            analysis_stages = ANALYSIS_STROBE;
+            ssd1306_fill(ssd, false);
+            ssd1306_draw_label(ssd, "Modo Estrobo", 16, 4);
+            ssd1306_draw_label(ssd, "Toque a nota", 17, 20);
+            ssd1306_send_data(ssd);
+            break;
+
+        case STRUM_MODE:
+            analysis_stages = ANALYSIS_STRUM;
+            ssd1306_fill(ssd, false);
+            ssd1306_draw_label(ssd, "Modo Cordas", 20, 4);
+            ssd1306_draw_label(ssd, "Toque as cordas", 4, 20);
+            ssd1306_send_data(ssd);
+            break;
+
+        case PROFILE_MODE:
+            render_profile(ssd);
+            break;
+
+        case RECORD_MODE: {
+            // Quadros que sobraram de uma gravação anterior são descartados
+            const uint8_t *frame;
+            size_t size;
+            while (record_queue_peek(&record_queue, &frame, &size)) record_queue_release(&record_queue);
+            record_sent = 0;
+            telemetry_mute(true);      // Nenhum texto entre os quadros
+            hal_console_binary(true);  // Fluxo binário: sem \n -> \r\n
+            recording = true;
+            render_record(ssd);
+            break;
+        }
+    }
+}
+
+// Ações de saída
+void exit_state(SystemState state) {
+    switch (state) {
+        case MODE_SELECTION:
+        case PROFILE_MODE:
+            break;
+        case TUNER_MODE:
+            clear_leds();
+            break;
+        case DIAPASON_MODE:
+            tone_stop();  // Para o buzzer (DMA e PWM)
+            break;
+        case STROBE_MODE:
+        case STRUM_MODE:
+            analysis_stages = 0;
+            clear_leds();
+            break;
+        case RECORD_MODE:
+            recording = false;
+            hal_console_binary(false);
+            telemetry_mute(false);
+            break;
+    }
+}
+
+// Dorme até o próximo evento: alarme dos botões, bloco da DMA ou, no modo
+// multicore, o SEV do núcleo 1. O retorno de qualquer interrupção arma o registrador
+// de eventos, então um evento ocorrido depois da última verificação não se perde.
+// Enquanto o OLED ainda transmite, acorda a cada 1 ms para disparar o quadro pendente.
+void wait_for_event(ssd1306_t *ssd) {
+    if (ssd1306_busy(ssd)) {
+        hal_wait_for_event_timeout_us(1000);
+    } else {
+        hal_wait_for_event();
+    }
 }
 
 // Função principal
 int main() {
-    stdio_init_all();  // Inicializa a comunicação serial
+    hal_console_init();  // Inicializa a comunicação serial
     init_components();  // Inicializa os componentes do hardware
+    telemetry_init_core();  // Ciclos por etapa (só com AFINADOR_TELEMETRY)
+#if AFINADOR_MULTICORE
+    multicore_launch_core1(core1_entry);  // Captura e análise no núcleo 1
+#endif
 
     // Inicializa o display OLED
     ssd1306_t ssd;
@@ -279,87 +874,92 @@ int main() {
     LedMatrix ledMatrix;  // Matriz de LEDs para exibir a nota
     clearLedMatrix(ledMatrix);  // Limpa a matriz de LEDs
 
+    active_state = current_state;
+    enter_state(active_state, &ssd, ledMatrix);
+
     while (true) {
-        switch (current_state) {
+        ssd1306_poll(&ssd);  // Conclui o envio anterior do OLED e dispara o quadro pendente
+        telemetry_poll();    // Esvazia os anéis e envia o quadro periódico
+        poll_console();      // Comandos pela serial
+
+        button_event_t event;
+        while (buttons_next(&buttons, &event)) handle_button(&event);
+
+        // Transição pedida pelos botões ou pelo console: sai do estado atual e entra no novo
+        SystemState requested = current_state;
+        if (requested != active_state) {
+            exit_state(active_state);
+            active_state = requested;
+            enter_state(active_state, &ssd, ledMatrix);
+        }
+
+        switch (active_state) {
             case MODE_SELECTION:
-                // Modo de seleção de função
-                clear_leds(); // Desliga os LEDs RGB
-                clearLedMatrix(ledMatrix); // Limpa a matriz de LEDs
-                displayPattern(ledMatrix, pio0, sm);  // Aplica o padrão limpo
-                stop_diapason();  // Para o buzzer
-                ssd1306_fill(&ssd, false);  // Limpa o display
-                ssd1306_draw_string(&ssd, "1: Afinador", 4, 4);
-                ssd1306_draw_string(&ssd, "2: Diapasao", 4, 20);
-                if (selected_note_index == false) {
-                    ssd1306_rect(&ssd, 0, 0, 128, 16, true, false);
-                } else {
-                    ssd1306_rect(&ssd, 16, 0, 128, 16, true, false);
+                // Redesenha o menu apenas quando a opção muda
+                if (selected_note_index != shown_selection) {
+                    render_menu(&ssd);
                 }
-                ssd1306_send_data(&ssd); // Envia os dados para o display
                 break;
 
             case TUNER_MODE: {
-                // Modo afinador
-                stop_diapason();  // Para o buzzer
-                ssd1306_fill(&ssd, false);  // Limpa o display
-
-                // Captura amostras do microfone
-                uint16_t buffer[BUFFER_SIZE];
-                for (uint32_t i = 0; i < BUFFER_SIZE; i++) {
-                    buffer[i] = adc_read();
-                    sleep_us(1000000 / SAMPLE_RATE);  // Mantém a taxa de amostragem
+                // Amplitude, frequência acompanhada e nota do bloco mais recente
+                analysis_result_t result;
+                if (next_analysis(&result)) {
+                    render_tuner(&ssd, ledMatrix, &result);
                 }
+                break;
+            }
 
-                // Calcula a amplitude do sinal
-                uint16_t amplitude = calculate_amplitude(buffer, BUFFER_SIZE);
-
-                // Verifica se o volume está acima do limiar
-                if (amplitude >= VOLUME_THRESHOLD) {
-                    // Calcula a frequência detectada
-                    float new_freq = calculate_frequency(buffer, BUFFER_SIZE, SAMPLE_RATE);
-
-                    // Suaviza a frequência detectada
-                    detected_freq = smooth_frequency(new_freq, detected_freq, SMOOTHING_FACTOR);
-
-                    // Determina a nota mais próxima
-                    uint8_t note_index = get_closest_note(detected_freq);
-
-                    // Exibe a nota na matriz de LEDs
-                    printf("Frequência detectada: %.2f Hz\n", detected_freq);
-                    getNote(note_index, ledMatrix);
-                    displayPattern(ledMatrix, pio0, sm);
+            case DIAPASON_MODE:
+                // O tom segue pela DMA; só é refeito quando a nota ou a referência muda
+                if (diapason_index != shown_diapason || reference_index != shown_reference) {
+                    render_diapason(&ssd, ledMatrix);
+                }
+                break;
 
-                    // Atualiza os LEDs RGB conforme o estado de afinação
-                    update_leds(detected_freq, note_index);
+            case STROBE_MODE: {
+                // O estrobo roda no caminho da análise, sobre todas as amostras do bloco
+                analysis_result_t result;
+                if (next_analysis(&result)) {
+                    render_strobe(&ssd, ledMatrix, &result);
+                }
+                break;
+            }
 
-                    // Exibe a frequência e a nota no display OLED
-                    char freq_str[20];
-                    snprintf(freq_str, sizeof(freq_str), "%.1f Hz", detected_freq);
-                    ssd1306_draw_string(&ssd, "Modo Afinador", 16, 4);
-                    ssd1306_draw_string(&ssd, freq_str, 32, 20);
-                } else {
-                    // Volume abaixo do limiar: ignora o sinal
-                    clear_leds(); // Desliga os LEDs RGB
-                    clearLedMatrix(ledMatrix); // Limpa a matriz de LEDs
-                    displayPattern(ledMatrix, pio0, sm); // Aplica o padrão limpo
-                    ssd1306_draw_string(&ssd, "Modo Afinador", 16, 4);
-                    ssd1306_draw_string(&ssd, "Toque a nota", 17, 20);
+            case STRUM_MODE: {
+                // O banco de ressonadores também roda no caminho da análise
+                analysis_result_t result;
+                if (next_analysis(&result)) {
+                    render_strum(&ssd, &result);
                 }
-                ssd1306_send_data(&ssd); // Envia os dados para o display
                 break;
             }
 
-            case DIAPASON_MODE:
-                // Modo diapasão
-                ssd1306_fill(&ssd, false);
-                ssd1306_draw_string(&ssd, "Modo Diapasao", 18, 4);
-                ssd1306_draw_string(&ssd, "440Hz", 49, 20);
-                ssd1306_send_data(&ssd);
-                play_diapason();  // Toca a nota A (440Hz)
-                getNote(5, ledMatrix);  // Exibe a nota A na matriz de LEDs
-                displayPattern(ledMatrix, pio0, sm);
+            case PROFILE_MODE:
+                // Redesenha apenas quando o joystick troca o perfil mostrado
+                if (browsed_profile != shown_profile) {
+                    render_profile(&ssd);
+                }
                 break;
+
+            case RECORD_MODE: {
+#if !AFINADOR_MULTICORE
+                // Sem o núcleo 1, a captura roda aqui: cada bloco do ADC vira um quadro
+                // em acquire_block() e a análise fica parada
+                const uint16_t *buffer;
+                uint32_t seq;
+                while (acquire_block(&buffer, &seq)) release_block();
+#endif
+                // Com dois núcleos a análise segue no núcleo 1; aqui só os quadros vão para a USB
+                send_record_frames();
+                if (record_sent / RECORD_FRAMES_PER_SCREEN != shown_record / RECORD_FRAMES_PER_SCREEN) {
+                    render_record(&ssd);  // Contadores atualizados a cada ~1 s
+                }
+                break;
+            }
         }
+
+        wait_for_event(&ssd);
     }
     return 0;
 }
\ No newline at end of file